@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+   typedef std::vector<std::pair<std::string, std::function<void ()> > > registry_t;
+
+   inline registry_t & registry()
+   {
+      static registry_t benchmarks;
+      return benchmarks;
+   }
+
+   struct registrar
+   {
+      registrar(std::string const & name, std::function<void ()> const & f)
+      {
+         registry().push_back(std::make_pair(name, f));
+      }
+   };
+
+   struct timer
+   {
+      timer()
+         : start_(std::chrono::steady_clock::now())
+      {}
+
+      double seconds() const
+      {
+         return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+      }
+
+   private:
+      std::chrono::steady_clock::time_point start_;
+   };
+
+   // prints time per item and throughput
+   inline void report(std::string const & name, size_t items, double seconds)
+   {
+      std::printf("%-48s %10zu items %10.3f ms %10.2f ns/item %14.0f items/s\n",
+                  name.c_str(), items, seconds * 1e3, seconds * 1e9 / items, items / seconds);
+   }
+
+   // keeps the optimizer from discarding benchmarked computations
+   template <class T>
+   void do_not_optimize(T const & value)
+   {
+      asm volatile("" : : "g"(&value) : "memory");
+   }
+}
+
+#define BENCHMARK(name)                                                   \
+   static void bench_##name();                                            \
+   static bench::registrar bench_registrar_##name(#name, &bench_##name);  \
+   static void bench_##name()
@@ -0,0 +1,115 @@
+#include <cg/operations/contains/contour_point.h>
+#include <cg/operations/contains/prepared_contour_point.h>
+#include <cg/convex_hull/graham.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "bench.h"
+#include "random_utils.h"
+
+namespace
+{
+   // a convex polygon with about the given number of vertices, the hull of points on a circle
+   cg::contour_2 convex_polygon(size_t vertices)
+   {
+      std::vector<cg::point_2> pts;
+      for (size_t l = 0; l != vertices; ++l)
+      {
+         double a = 2 * 3.14159265358979323846 * l / vertices;
+         pts.push_back(cg::point_2(100 * std::cos(a), 100 * std::sin(a)));
+      }
+      pts.erase(cg::graham_hull(pts.begin(), pts.end()), pts.end());
+      return cg::contour_2(pts);
+   }
+
+   void convex_contains(size_t vertices, std::vector<cg::point_2> const & queries)
+   {
+      cg::contour_2 polygon = convex_polygon(vertices);
+      std::string name = "contains/convex/" + std::to_string(polygon.size());
+
+      {
+         bench::timer t;
+         size_t inside = 0;
+         for (cg::point_2 const & q : queries)
+            inside += cg::convex_contains(polygon, q);
+         bench::do_not_optimize(inside);
+         bench::report(name + "/convex_contains", queries.size(), t.seconds());
+      }
+
+      cg::prepared_convex_contour<double> prepared(polygon);
+      {
+         bench::timer t;
+         size_t inside = 0;
+         for (cg::point_2 const & q : queries)
+            inside += prepared.contains(q);
+         bench::do_not_optimize(inside);
+         bench::report(name + "/prepared", queries.size(), t.seconds());
+      }
+      {
+         std::vector<char> res(queries.size());
+         bench::timer t;
+         prepared.contains(queries.begin(), queries.end(), res.begin());
+         bench::do_not_optimize(res);
+         bench::report(name + "/prepared_batch", queries.size(), t.seconds());
+      }
+   }
+
+   void contour_contains(size_t vertices, double noise, std::vector<cg::point_2> const & queries)
+   {
+      // a wavy circle, the radius also changes randomly by up to noise from vertex to vertex
+      util::uniform_random_real<double> rand(-noise, noise);
+      std::vector<cg::point_2> pts;
+      for (size_t l = 0; l != vertices; ++l)
+      {
+         double a = 2 * 3.14159265358979323846 * l / vertices, r;
+         rand >> r;
+         r += 90 + 5 * std::sin(40 * a);
+         pts.push_back(cg::point_2(r * std::cos(a), r * std::sin(a)));
+      }
+      cg::contour_2 polygon(pts);
+      std::string name = "contains/contour/" + std::to_string(vertices) + "/noise:" + std::to_string(noise).substr(0, 4);
+
+      {
+         // the scan of all the edges, on fewer queries
+         size_t count = std::min<size_t>(queries.size(), (1 << 24) / vertices);
+         bench::timer t;
+         size_t inside = 0;
+         for (size_t l = 0; l != count; ++l)
+            inside += cg::contains(polygon, queries[l]);
+         bench::do_not_optimize(inside);
+         bench::report(name + "/contains", count, t.seconds());
+      }
+      {
+         bench::timer t;
+         cg::prepared_contour<double> prepared(polygon);
+         bench::do_not_optimize(&prepared);
+         bench::report(name + "/prepared/build", vertices, t.seconds());
+
+         t = bench::timer();
+         size_t inside = 0;
+         for (cg::point_2 const & q : queries)
+            inside += prepared.contains(q);
+         bench::do_not_optimize(inside);
+         bench::report(name + "/prepared", queries.size(), t.seconds());
+      }
+   }
+}
+
+BENCHMARK(contains_convex)
+{
+   std::vector<cg::point_2> queries = uniform_points(1 << 20);
+   for (size_t vertices : {16, 1000, 100000})
+      convex_contains(vertices, queries);
+}
+
+BENCHMARK(contains_contour)
+{
+   std::vector<cg::point_2> queries = uniform_points(1 << 20);
+   for (size_t vertices : {1000, 100000})
+   {
+      contour_contains(vertices, 0.01, queries);
+      contour_contains(vertices, 5, queries);
+   }
+}
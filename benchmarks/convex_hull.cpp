@@ -0,0 +1,362 @@
+#include <cg/convex_hull/andrew.h>
+#include <cg/convex_hull/graham.h>
+#include <cg/convex_hull/quick_hull.h>
+#include <cg/convex_hull/jarvis.h>
+#include <cg/convex_hull/akl_toussaint.h>
+#include <cg/convex_hull/chan.h>
+#include <cg/convex_hull/dynamic.h>
+#include <cg/convex_hull/incremental.h>
+#include <cg/convex_hull/streaming.h>
+#include <cg/convex_hull/batch.h>
+#include <cg/convex_hull/melkman.h>
+#include <cg/convex_hull/naive_dynamic.h>
+
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "bench.h"
+#include "random_utils.h"
+
+namespace
+{
+   struct andrew
+   {
+      template <class Iter>
+      Iter operator() (Iter begin, Iter end) const { return cg::andrew_hull(begin, end); }
+   };
+
+   struct graham
+   {
+      template <class Iter>
+      Iter operator() (Iter begin, Iter end) const { return cg::graham_hull(begin, end); }
+   };
+
+   struct quick
+   {
+      template <class Iter>
+      Iter operator() (Iter begin, Iter end) const { return cg::quick_hull(begin, end); }
+   };
+
+   struct jarvis
+   {
+      template <class Iter>
+      Iter operator() (Iter begin, Iter end) const { return cg::jarvis_hull(begin, end); }
+   };
+
+   struct chan
+   {
+      template <class Iter>
+      Iter operator() (Iter begin, Iter end) const { return cg::chan_hull(begin, end); }
+   };
+
+   template <class Hull>
+   struct filtered
+   {
+      template <class Iter>
+      Iter operator() (Iter begin, Iter end) const { return cg::akl_toussaint_hull(begin, end, Hull()); }
+   };
+
+   // uniform points of a 2^21 x 2^21 grid, which all the scalar types represent exactly
+   std::vector<cg::point_2i> grid_points(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::uniform_int_distribution<int> coord(-(1 << 20), 1 << 20);
+      std::vector<cg::point_2i> res(count);
+      for (cg::point_2i & p : res)
+         p = cg::point_2i(coord(rng), coord(rng));
+      return res;
+   }
+
+   template <class Hull, class Point>
+   void hull(std::string const & name, std::vector<Point> const & pts)
+   {
+      const size_t rounds = 4;
+
+      double elapsed = 0;
+      for (size_t k = 0; k != rounds; ++k)
+      {
+         std::vector<Point> work = pts;
+         bench::timer t;
+         bench::do_not_optimize(Hull()(work.begin(), work.end()));
+         elapsed += t.seconds();
+      }
+      bench::report(name, rounds * pts.size(), elapsed);
+   }
+
+   // the same points stored with double, float and int coordinates
+   template <class Hull>
+   void hull_by_scalar(std::string const & algorithm, size_t count)
+   {
+      std::vector<cg::point_2i> pts = grid_points(count);
+      std::string name = "convex_hull/" + algorithm + "/" + std::to_string(count);
+
+      hull<Hull>(name + "/double", std::vector<cg::point_2>(pts.begin(), pts.end()));
+      hull<Hull>(name + "/float", std::vector<cg::point_2f>(pts.begin(), pts.end()));
+      hull<Hull>(name + "/int", pts);
+   }
+}
+
+BENCHMARK(convex_hull_scalar)
+{
+   for (size_t count : {100000, 1000000})
+   {
+      hull_by_scalar<andrew>("andrew", count);
+      hull_by_scalar<graham>("graham", count);
+      hull_by_scalar<quick>("quick_hull", count);
+   }
+}
+
+BENCHMARK(convex_hull_parallel)
+{
+   const size_t count = 10000000;
+   std::vector<cg::point_2i> ipts = grid_points(count);
+   std::vector<cg::point_2> pts(ipts.begin(), ipts.end());
+   size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+   for (size_t threads = 1; ; threads = std::min(2 * threads, max_threads))
+   {
+      std::vector<cg::point_2> work = pts;
+      bench::timer t;
+      bench::do_not_optimize(cg::quick_hull(work.begin(), work.end(), threads));
+      bench::report("convex_hull/quick_hull/parallel/" + std::to_string(count) + "/threads:" + std::to_string(threads), count, t.seconds());
+
+      work = pts;
+      t = bench::timer();
+      bench::do_not_optimize(cg::andrew_hull(work.begin(), work.end(), threads));
+      bench::report("convex_hull/andrew/parallel/" + std::to_string(count) + "/threads:" + std::to_string(threads), count, t.seconds());
+
+      work = pts;
+      t = bench::timer();
+      bench::do_not_optimize(cg::graham_hull(work.begin(), work.end(), threads));
+      bench::report("convex_hull/graham/parallel/" + std::to_string(count) + "/threads:" + std::to_string(threads), count, t.seconds());
+      if (threads == max_threads)
+         break;
+   }
+}
+
+BENCHMARK(convex_hull_akl_toussaint)
+{
+   const size_t count = 1000000;
+   std::vector<cg::point_2> pts = uniform_points(count);
+   std::vector<cg::point_2> work = pts;
+
+   bench::timer t;
+   size_t kept = cg::akl_toussaint_filter(work.begin(), work.end()) - work.begin();
+   bench::report("convex_hull/akl_toussaint/filter/" + std::to_string(count), count, t.seconds());
+   std::printf("%-48s %10zu of %zu points kept\n", "convex_hull/akl_toussaint/filter", kept, count);
+
+   std::string name = "convex_hull/akl_toussaint/" + std::to_string(count);
+   hull<andrew>(name + "/andrew", pts);
+   hull<filtered<andrew> >(name + "/andrew/filtered", pts);
+   hull<graham>(name + "/graham", pts);
+   hull<filtered<graham> >(name + "/graham/filtered", pts);
+   hull<quick>(name + "/quick_hull", pts);
+   hull<filtered<quick> >(name + "/quick_hull/filtered", pts);
+   hull<jarvis>(name + "/jarvis", pts);
+   hull<filtered<jarvis> >(name + "/jarvis/filtered", pts);
+}
+
+BENCHMARK(convex_hull_chan)
+{
+   for (size_t count : {100000, 1000000})
+   {
+      std::vector<cg::point_2> pts = uniform_points(count);
+      std::string name = "convex_hull/output_sensitive/" + std::to_string(count);
+      hull<graham>(name + "/graham", pts);
+      hull<jarvis>(name + "/jarvis", pts);
+      hull<chan>(name + "/chan", pts);
+   }
+}
+
+namespace
+{
+   // a tracking tick: updates points, half of them removed and half added, then the hull is read
+   template <class DynamicHull>
+   void dynamic_hull(std::string const & name, size_t count, size_t updates, size_t ticks)
+   {
+      std::vector<cg::point_2> pts = uniform_points(count + ticks * updates / 2);
+      DynamicHull dh;
+      for (size_t i = 0; i != count; ++i)
+         dh.add_point(pts[i]);
+
+      std::mt19937 rng(0x5eed);
+      std::vector<cg::point_2> present(pts.begin(), pts.begin() + count);
+      size_t next = count, hull_size = 0;
+      bench::timer t;
+      for (size_t tick = 0; tick != ticks; ++tick)
+      {
+         for (size_t k = 0; k != updates / 2; ++k)
+         {
+            size_t i = std::uniform_int_distribution<size_t>(0, present.size() - 1)(rng);
+            dh.remove_point(present[i]);
+            present[i] = pts[next++];
+            dh.add_point(present[i]);
+         }
+         std::pair<cg::vect_it, cg::vect_it> hull = dh.get_hull();
+         hull_size += hull.second - hull.first;
+      }
+      bench::do_not_optimize(hull_size);
+      bench::report(name + "/" + std::to_string(count) + "/updates:" + std::to_string(updates), ticks * updates, t.seconds());
+   }
+}
+
+BENCHMARK(convex_hull_dynamic)
+{
+   for (size_t count : {10000, 100000})
+   {
+      dynamic_hull<cg::naive_dynamic_hull>("convex_hull/dynamic/naive", count, 1000, 10);
+      dynamic_hull<cg::dynamic_hull>("convex_hull/dynamic/overmars_van_leeuwen", count, 1000, 10);
+   }
+}
+
+namespace
+{
+   // a feed of points, the hull is read after every chunk of them
+   template <class Hull>
+   void streaming_hull(std::string const & name, std::vector<cg::point_2> const & pts, size_t chunk)
+   {
+      Hull h;
+      size_t hull_size = 0;
+      bench::timer t;
+      for (size_t i = 0; i != pts.size(); ++i)
+      {
+         h.add_point(pts[i]);
+         if ((i + 1) % chunk == 0)
+         {
+            std::pair<cg::vect_it, cg::vect_it> hull = h.get_hull();
+            hull_size += hull.second - hull.first;
+         }
+      }
+      bench::do_not_optimize(hull_size);
+      bench::report(name + "/" + std::to_string(pts.size()) + "/chunk:" + std::to_string(chunk), pts.size(), t.seconds());
+   }
+
+   // a track: every point is a random step from the previous one
+   std::vector<cg::point_2> random_walk(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::normal_distribution<double> step(0., 1.);
+      std::vector<cg::point_2> res(count);
+      for (size_t i = 1; i != count; ++i)
+         res[i] = cg::point_2(res[i - 1].x + step(rng), res[i - 1].y + step(rng));
+      return res;
+   }
+}
+
+BENCHMARK(convex_hull_incremental)
+{
+   const size_t count = 100000;
+   std::vector<cg::point_2> uniform = uniform_points(count), walk = random_walk(count);
+   for (size_t chunk : {1000, 10000})
+   {
+      streaming_hull<cg::naive_dynamic_hull>("convex_hull/incremental/uniform/naive", uniform, chunk);
+      streaming_hull<cg::incremental_hull>("convex_hull/incremental/uniform/incremental", uniform, chunk);
+      streaming_hull<cg::naive_dynamic_hull>("convex_hull/incremental/random_walk/naive", walk, chunk);
+      streaming_hull<cg::incremental_hull>("convex_hull/incremental/random_walk/incremental", walk, chunk);
+   }
+
+   cg::incremental_hull h;
+   for (cg::point_2 const & p : uniform)
+      h.add_point(p);
+   std::vector<cg::point_2> queries = uniform_points(1000000);
+   size_t inside = 0;
+   bench::timer t;
+   for (cg::point_2 const & q : queries)
+      inside += h.contains(q);
+   bench::do_not_optimize(inside);
+   bench::report("convex_hull/incremental/contains", queries.size(), t.seconds());
+}
+
+BENCHMARK(convex_hull_streaming)
+{
+   const size_t count = 4000000;
+   std::vector<cg::point_2> pts = uniform_points(count);
+   std::string name = "convex_hull/streaming/" + std::to_string(count);
+   hull<andrew>(name + "/andrew_in_memory", pts);
+   hull<filtered<andrew> >(name + "/andrew_in_memory/filtered", pts);
+
+   for (size_t chunk : {size_t(1) << 12, size_t(1) << 16, size_t(1) << 20})
+   {
+      bench::timer t;
+      cg::streaming_hull<cg::point_2> h(chunk);
+      h.add_points(pts.begin(), pts.end());
+      bench::do_not_optimize(h.hull());
+      bench::report(name + "/chunk:" + std::to_string(chunk), count, t.seconds());
+   }
+
+   std::stringstream text;
+   for (size_t i = 0; i != count / 4; ++i)
+      text << pts[i] << "\n";
+   bench::timer t;
+   bench::do_not_optimize(cg::streaming_hull_of<double>(text, 1 << 16));
+   bench::report("convex_hull/streaming/" + std::to_string(count / 4) + "/text/chunk:65536", count / 4, t.seconds());
+}
+
+BENCHMARK(convex_hull_batch)
+{
+   // many clusters of 10 to 200 points
+   const size_t sets = 100000;
+   std::mt19937 gen(17);
+   std::uniform_int_distribution<size_t> size(10, 200);
+   std::vector<std::vector<cg::point_2> > clusters;
+   std::vector<cg::point_2> points;
+   std::vector<size_t> offsets(1, 0);
+   for (size_t i = 0; i != sets; ++i)
+   {
+      clusters.push_back(uniform_points(size(gen)));
+      points.insert(points.end(), clusters.back().begin(), clusters.back().end());
+      offsets.push_back(points.size());
+   }
+
+   {
+      bench::timer t;
+      size_t total = 0;
+      for (std::vector<cg::point_2> const & cluster : clusters)
+      {
+         std::vector<cg::point_2> work = cluster;
+         work.erase(cg::andrew_hull(work.begin(), work.end()), work.end());
+         total += work.size();
+      }
+      bench::do_not_optimize(total);
+      bench::report("convex_hull/batch/per_set_vectors/" + std::to_string(sets), points.size(), t.seconds());
+   }
+
+   std::vector<cg::point_2> hull_points;
+   std::vector<size_t> hull_offsets;
+   size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+   for (size_t threads = 1; ; threads = std::min(2 * threads, max_threads))
+   {
+      bench::timer t;
+      cg::batch_hull(points, offsets, hull_points, hull_offsets, threads);
+      bench::do_not_optimize(hull_points.size());
+      bench::report("convex_hull/batch/csr/" + std::to_string(sets) + "/threads:" + std::to_string(threads), points.size(), t.seconds());
+      if (threads == max_threads)
+         break;
+   }
+}
+
+BENCHMARK(convex_hull_melkman)
+{
+   // a star-shaped polygon, the vertices sorted by the angle around the origin
+   for (size_t count : {100000, 1000000})
+   {
+      std::vector<cg::point_2> pts = uniform_points(count);
+      std::sort(pts.begin(), pts.end(), [](cg::point_2 const & a, cg::point_2 const & b)
+                                        { return std::atan2(a.y, a.x) < std::atan2(b.y, b.x); });
+      cg::contour_2 contour(pts);
+
+      {
+         std::vector<cg::point_2> work = pts;
+         bench::timer t;
+         bench::do_not_optimize(cg::graham_hull(work.begin(), work.end()));
+         bench::report("convex_hull/polygon/graham/" + std::to_string(count), count, t.seconds());
+      }
+      {
+         bench::timer t;
+         cg::contour_2 hull = cg::melkman_hull(contour);
+         bench::do_not_optimize(hull.size());
+         bench::report("convex_hull/polygon/melkman/" + std::to_string(count), count, t.seconds());
+      }
+   }
+}
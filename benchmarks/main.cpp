@@ -0,0 +1,23 @@
+#include <cstring>
+#include <iostream>
+
+#include <cg/common/predicate_stats.h>
+
+#include "bench.h"
+
+// usage: cg-bench [substring of benchmark name]
+int main(int argc, char ** argv)
+{
+   for (auto const & b : bench::registry())
+   {
+      if (argc > 1 && b.first.find(argv[1]) == std::string::npos)
+         continue;
+
+      b.second();
+
+#ifdef CG_PREDICATE_STATS
+      cg::predicate_stats::dump(std::cout);
+      cg::predicate_stats::reset();
+#endif
+   }
+}
@@ -0,0 +1,278 @@
+#include <cg/operations/orientation.h>
+#include <cg/operations/orientation_batch.h>
+#include <cg/operations/distance.h>
+#include <cg/triangulation/delaunay.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "bench.h"
+#include "random_utils.h"
+
+namespace
+{
+   // arguments of one call, the orientation uses the first three points
+   typedef std::array<cg::point_2, 4> arguments;
+
+   const size_t inexact_count = 1 << 20;
+   const size_t degenerate_count = 1 << 16;
+
+   std::vector<arguments> uniform_arguments(size_t count)
+   {
+      std::vector<cg::point_2> pts = uniform_points(4 * count);
+      std::vector<arguments> res(count);
+      for (size_t i = 0; i != count; ++i)
+         for (size_t k = 0; k != 4; ++k)
+            res[i][k] = pts[4 * i + k];
+      return res;
+   }
+
+   // c and d lie on the line ab up to rounding
+   std::vector<arguments> nearly_collinear_arguments(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::uniform_real_distribution<double> coord(-100., 100.), t(-2., 2.);
+      std::vector<arguments> res(count);
+      for (arguments & args : res)
+      {
+         cg::point_2 a(coord(rng), coord(rng)), b(coord(rng), coord(rng));
+         args = {{a, b, a + t(rng) * (b - a), a + t(rng) * (b - a)}};
+      }
+      return res;
+   }
+
+   // small integer points on a common line
+   std::vector<arguments> collinear_arguments(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::uniform_int_distribution<int> coord(-1000, 1000), step(-10, 10);
+      std::vector<arguments> res(count);
+      for (arguments & args : res)
+      {
+         cg::point_2 a(coord(rng), coord(rng));
+         cg::vector_2 v(step(rng), step(rng));
+         args = {{a, a + double(step(rng)) * v, a + double(step(rng)) * v, a + double(step(rng)) * v}};
+      }
+      return res;
+   }
+
+   // points of a circle up to rounding, abc is counterclockwise
+   std::vector<arguments> nearly_cocircular_arguments(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::uniform_real_distribution<double> coord(-100., 100.), radius(1., 10.), angle(0., 6.283185307179586);
+      std::vector<arguments> res(count);
+      for (arguments & args : res)
+      {
+         cg::point_2 o(coord(rng), coord(rng));
+         double r = radius(rng);
+         double phi[4];
+         for (double & p : phi)
+            p = angle(rng);
+         std::sort(phi, phi + 3);
+         for (size_t k = 0; k != 4; ++k)
+            args[k] = cg::point_2(o.x + r * std::cos(phi[k]), o.y + r * std::sin(phi[k]));
+      }
+      return res;
+   }
+
+   // integer points of the circle of radius 5
+   std::vector<arguments> cocircular_arguments(size_t count)
+   {
+      const int circle[12][2] = {{5, 0}, {4, 3}, {3, 4}, {0, 5}, {-3, 4}, {-4, 3},
+                                 {-5, 0}, {-4, -3}, {-3, -4}, {0, -5}, {3, -4}, {4, -3}};
+      std::mt19937 rng(0x5eed);
+      std::uniform_int_distribution<int> coord(-1000, 1000), index(0, 11);
+      std::vector<arguments> res(count);
+      for (arguments & args : res)
+      {
+         cg::point_2 o(coord(rng), coord(rng));
+         int k[4];
+         for (int & i : k)
+            i = index(rng);
+         std::sort(k, k + 3);
+         for (size_t i = 0; i != 4; ++i)
+            args[i] = cg::point_2(o.x + circle[k[i]][0], o.y + circle[k[i]][1]);
+      }
+      return res;
+   }
+
+   template <class Predicate>
+   void time_calls(std::string const & name, std::vector<arguments> const & input, Predicate predicate)
+   {
+      bench::timer t;
+      int sum = 0;
+      for (arguments const & args : input)
+         sum += int(predicate(args));
+      double elapsed = t.seconds();
+
+      bench::do_not_optimize(sum);
+      bench::report(name, input.size(), elapsed);
+   }
+
+   // fractions of the calls which the filter, the interval and the expansion stages leave undecided
+   template <class Filter, class Interval, class Expansion>
+   void report_stages(std::string const & name, std::vector<arguments> const & input,
+                      Filter filter, Interval interval, Expansion expansion)
+   {
+      size_t to_interval = 0, to_expansion = 0, to_exact = 0;
+      for (arguments const & args : input)
+      {
+         if (filter(args))
+            continue;
+         ++to_interval;
+         if (interval(args))
+            continue;
+         ++to_expansion;
+         if (!expansion(args))
+            ++to_exact;
+      }
+      std::printf("%-48s %9.4f%% to interval %9.4f%% to expansion %9.4f%% to mpq\n", name.c_str(),
+                  100. * to_interval / input.size(), 100. * to_expansion / input.size(), 100. * to_exact / input.size());
+   }
+
+   void orientation(std::string const & kind, std::vector<arguments> const & input)
+   {
+      std::string name = "predicates/orientation/" + kind;
+      time_calls(name, input, [](arguments const & a) { return cg::orientation(a[0], a[1], a[2]); });
+      report_stages(name, input,
+                    [](arguments const & a) { return bool(cg::orientation_d()(a[0], a[1], a[2])); },
+                    [](arguments const & a) { return bool(cg::orientation_i()(a[0], a[1], a[2])); },
+                    [](arguments const & a) { return bool(cg::orientation_e()(a[0], a[1], a[2])); });
+
+      double max_abs = 0;
+      for (arguments const & a : input)
+         max_abs = std::max(max_abs, cg::max_abs_coordinate(a.begin(), a.end()));
+      cg::orientation_semi_static semi_static(max_abs);
+      name = "predicates/orientation_semi_static/" + kind;
+      time_calls(name, input, [&](arguments const & a) { return semi_static(a[0], a[1], a[2]); });
+      report_stages(name, input,
+                    [&](arguments const & a) { return semi_static.filter(a[0], a[1], a[2]) != cg::CG_COLLINEAR; },
+                    [](arguments const & a) { return bool(cg::orientation_i()(a[0], a[1], a[2])); },
+                    [](arguments const & a) { return bool(cg::orientation_e()(a[0], a[1], a[2])); });
+   }
+
+   void delaunay_criterion(std::string const & kind, std::vector<arguments> const & input)
+   {
+      std::string name = "predicates/delaunay_criterion/" + kind;
+      time_calls(name, input, [](arguments const & a) { return cg::delaunay_criterion(a[0], a[1], a[2], a[3]); });
+      report_stages(name, input,
+                    [](arguments const & a) { return bool(cg::delaunay_criterion_d()(a[0], a[1], a[2], a[3])); },
+                    [](arguments const & a) { return bool(cg::delaunay_criterion_i()(a[0], a[1], a[2], a[3])); },
+                    [](arguments const & a) { return bool(cg::delaunay_criterion_e()(a[0], a[1], a[2], a[3])); });
+   }
+
+   void cmp_dist(std::string const & kind, std::vector<arguments> const & input)
+   {
+      std::string name = "predicates/cmp_dist/" + kind;
+      time_calls(name, input, [](arguments const & a) { return cg::cmp_dist(a[0], a[1], a[2], a[3]); });
+      report_stages(name, input,
+                    [](arguments const & a) { return bool(cg::cmp_dist_d()(a[0], a[1], a[2], a[3])); },
+                    [](arguments const & a) { return bool(cg::cmp_dist_i()(a[0], a[1], a[2], a[3])); },
+                    [](arguments const & a) { return bool(cg::cmp_dist_e()(a[0], a[1], a[2], a[3])); });
+   }
+
+   // orientations of many points against the line through the first two, one by one and in one batch
+   void orientation_batch(std::string const & kind, std::vector<cg::point_2> const & pts)
+   {
+      const size_t rounds = 16;
+      cg::point_2 a = pts[0], b = pts[1];
+      std::vector<cg::orientation_t> res(pts.size());
+
+      bench::timer t;
+      for (size_t k = 0; k != rounds; ++k)
+      {
+         for (size_t i = 0; i != pts.size(); ++i)
+            res[i] = cg::orientation(a, b, pts[i]);
+         bench::do_not_optimize(res);
+      }
+      bench::report("predicates/orientation_batch/" + kind + "/per_call", rounds * pts.size(), t.seconds());
+
+      t = bench::timer();
+      for (size_t k = 0; k != rounds; ++k)
+      {
+         cg::orientation_batch(a, b, pts.data(), pts.size(), res.data());
+         bench::do_not_optimize(res);
+      }
+      bench::report("predicates/orientation_batch/" + kind + "/batch", rounds * pts.size(), t.seconds());
+   }
+
+   // every eighth point lies on the line through the first two up to rounding
+   std::vector<cg::point_2> nearly_collinear_points(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::uniform_real_distribution<double> t(-2., 2.);
+      std::vector<cg::point_2> res = uniform_points(count);
+      for (size_t i = 2; i < count; i += 8)
+         res[i] = res[0] + t(rng) * (res[1] - res[0]);
+      return res;
+   }
+
+   // snapped to a 2^30 grid, the same points with double and with int coordinates
+   void orientation_integer(size_t count)
+   {
+      std::mt19937 rng(0x5eed);
+      std::uniform_int_distribution<int> coord(-(1 << 30), 1 << 30);
+      std::vector<cg::point_2i> pts(count);
+      for (cg::point_2i & p : pts)
+         p = cg::point_2i(coord(rng), coord(rng));
+      std::vector<cg::point_2> dpts(pts.begin(), pts.end());
+
+      bench::timer t;
+      int sum = 0;
+      for (size_t i = 2; i < count; ++i)
+         sum += cg::orientation(dpts[i - 2], dpts[i - 1], dpts[i]);
+      bench::do_not_optimize(sum);
+      bench::report("predicates/orientation_integer/double", count - 2, t.seconds());
+
+      t = bench::timer();
+      for (size_t i = 2; i < count; ++i)
+         sum += cg::orientation(pts[i - 2], pts[i - 1], pts[i]);
+      bench::do_not_optimize(sum);
+      bench::report("predicates/orientation_integer/int", count - 2, t.seconds());
+   }
+
+   // |cd| is |ab| turned by a right angle, exactly for integer points
+   std::vector<arguments> equal_distance_arguments(std::vector<arguments> input)
+   {
+      for (arguments & args : input)
+      {
+         cg::vector_2 v = args[1] - args[0];
+         args[3] = args[2] + cg::vector_2(-v.y, v.x);
+      }
+      return input;
+   }
+}
+
+BENCHMARK(predicates_orientation)
+{
+   orientation("uniform", uniform_arguments(inexact_count));
+   orientation("nearly_collinear", nearly_collinear_arguments(inexact_count));
+   orientation("collinear", collinear_arguments(degenerate_count));
+}
+
+BENCHMARK(predicates_orientation_integer)
+{
+   orientation_integer(inexact_count);
+}
+
+BENCHMARK(predicates_orientation_batch)
+{
+   orientation_batch("uniform", uniform_points(inexact_count));
+   orientation_batch("nearly_collinear", nearly_collinear_points(inexact_count));
+}
+
+BENCHMARK(predicates_delaunay_criterion)
+{
+   delaunay_criterion("uniform", uniform_arguments(inexact_count));
+   delaunay_criterion("nearly_cocircular", nearly_cocircular_arguments(inexact_count));
+   delaunay_criterion("cocircular", cocircular_arguments(degenerate_count));
+}
+
+BENCHMARK(predicates_cmp_dist)
+{
+   cmp_dist("uniform", uniform_arguments(inexact_count));
+   cmp_dist("nearly_equal", equal_distance_arguments(uniform_arguments(inexact_count)));
+   cmp_dist("equal", equal_distance_arguments(collinear_arguments(degenerate_count)));
+}
@@ -0,0 +1,197 @@
+#include <cg/triangulation/delaunay.h>
+#include <cg/triangulation/delaunay_dc.h>
+
+#include <cmath>
+#include <thread>
+
+#include "bench.h"
+#include "random_utils.h"
+
+namespace
+{
+   void incremental(size_t count)
+   {
+      std::vector<cg::point_2> pts = uniform_points(count);
+
+      bench::timer t;
+      cg::triangulation<double> tr;
+      for (cg::point_2 const & p : pts)
+         tr.add_point(p);
+      double elapsed = t.seconds();
+
+      bench::do_not_optimize(tr);
+      bench::report("triangulation/add_point/" + std::to_string(count), count, elapsed);
+   }
+
+   void bulk(size_t count)
+   {
+      std::vector<cg::point_2> pts = uniform_points(count);
+
+      bench::timer t;
+      cg::triangulation<double> tr(pts.begin(), pts.end());
+      double elapsed = t.seconds();
+
+      bench::do_not_optimize(tr);
+      bench::report("triangulation/bulk/" + std::to_string(count), count, elapsed);
+   }
+
+   void divide_and_conquer(size_t count, size_t threads, std::string const & name)
+   {
+      std::vector<cg::point_2> pts = uniform_points(count);
+
+      bench::timer t;
+      cg::static_triangulation<double> tr(pts.begin(), pts.end(), threads);
+      double elapsed = t.seconds();
+
+      bench::do_not_optimize(tr);
+      bench::report(name, count, elapsed);
+   }
+
+   // keeps the last count points of a stream of 4 * count
+   void sliding_window(size_t count)
+   {
+      std::vector<cg::point_2> pts = uniform_points(4 * count);
+      cg::triangulation<double> tr(pts.begin(), pts.begin() + count);
+
+      bench::timer t;
+      for (size_t i = count; i != pts.size(); ++i)
+      {
+         tr.remove_point(pts[i - count]);
+         tr.add_point(pts[i]);
+      }
+      double elapsed = t.seconds();
+
+      bench::do_not_optimize(tr);
+      bench::report("triangulation/sliding_window/" + std::to_string(count), 3 * count, elapsed);
+   }
+
+   // the center of a slightly uneven ring of degree points is removed and added back; on the hull, the
+   // point is just below the center of a half ring
+   void high_degree(size_t degree, bool hull)
+   {
+      const size_t rounds = 20;
+      double arc = hull ? 3.141592653589793 / (degree - 1) : 6.283185307179586 / degree;
+      std::vector<cg::point_2> pts;
+      for (size_t i = 0; i != degree; ++i)
+      {
+         double phi = arc * i, r = 1 + 1e-8 * (i * 7919 % 101);
+         pts.push_back(cg::point_2(r * std::cos(phi), r * std::sin(phi)));
+      }
+      cg::triangulation<double> tr(pts.begin(), pts.end());
+      cg::point_2 center(0, hull ? -1e-3 : 0);
+
+      double elapsed = 0;
+      for (size_t i = 0; i != rounds; ++i)
+      {
+         tr.add_point(center);
+         bench::timer t;
+         tr.remove_point(center);
+         elapsed += t.seconds();
+      }
+
+      bench::do_not_optimize(tr);
+      bench::report(std::string("triangulation/remove_point/") + (hull ? "hull_degree:" : "degree:")
+                    + std::to_string(degree), rounds, elapsed);
+   }
+
+   // one frame worth of mesh export, repeated
+   void export_mesh(size_t count)
+   {
+      const size_t frames = 20;
+      std::vector<cg::point_2> pts = uniform_points(count);
+      cg::triangulation<double> tr(pts.begin(), pts.end());
+
+      bench::timer t;
+      for (size_t i = 0; i != frames; ++i)
+         bench::do_not_optimize(tr.get_triangles());
+      bench::report("triangulation/export/get_triangles/" + std::to_string(count), frames, t.seconds());
+
+      t = bench::timer();
+      for (size_t i = 0; i != frames; ++i)
+      {
+         double sum = 0;
+         for (cg::triangle_2 const & tri : tr.finite_faces())
+            sum += tri[0].x;
+         bench::do_not_optimize(sum);
+      }
+      bench::report("triangulation/export/finite_faces/" + std::to_string(count), frames, t.seconds());
+
+      std::vector<cg::point_2> vertices;
+      std::vector<std::array<std::uint32_t, 3> > triangles;
+      t = bench::timer();
+      for (size_t i = 0; i != frames; ++i)
+      {
+         tr.export_indexed(vertices, triangles);
+         bench::do_not_optimize(triangles);
+      }
+      bench::report("triangulation/export/export_indexed/" + std::to_string(count), frames, t.seconds());
+   }
+
+   void locate(size_t count, size_t queries)
+   {
+      cg::triangulation<double> tr;
+      for (cg::point_2 const & p : uniform_points(count))
+         tr.add_point(p);
+      std::vector<cg::point_2> pts = uniform_points(queries);
+
+      bench::timer t;
+      size_t found = 0;
+      for (cg::point_2 const & p : pts)
+         found += bool(tr.locate(p));
+      double elapsed = t.seconds();
+
+      bench::do_not_optimize(found);
+      bench::report("triangulation/locate/" + std::to_string(count), queries, elapsed);
+   }
+}
+
+BENCHMARK(triangulation_add_point)
+{
+   for (size_t count : {1000, 10000, 100000, 1000000})
+      incremental(count);
+}
+
+BENCHMARK(triangulation_bulk)
+{
+   for (size_t count : {1000, 10000, 100000, 1000000})
+      bulk(count);
+}
+
+BENCHMARK(triangulation_divide_and_conquer)
+{
+   for (size_t count : {1000, 10000, 100000, 1000000})
+      divide_and_conquer(count, 1, "triangulation/divide_and_conquer/" + std::to_string(count));
+}
+
+BENCHMARK(triangulation_parallel)
+{
+   const size_t count = 4000000;
+   size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+   for (size_t threads = 1; ; threads = std::min(2 * threads, max_threads))
+   {
+      divide_and_conquer(count, threads, "triangulation/parallel/" + std::to_string(count) + "/threads:" + std::to_string(threads));
+      if (threads == max_threads)
+         break;
+   }
+}
+
+BENCHMARK(triangulation_remove_point)
+{
+   for (size_t count : {1000, 10000, 100000})
+      sliding_window(count);
+   for (bool hull : {false, true})
+      for (size_t degree : {10, 100, 1000})
+         high_degree(degree, hull);
+}
+
+BENCHMARK(triangulation_export)
+{
+   for (size_t count : {10000, 1000000})
+      export_mesh(count);
+}
+
+BENCHMARK(triangulation_locate)
+{
+   for (size_t count : {1000, 10000, 100000, 1000000})
+      locate(count, 100000);
+}
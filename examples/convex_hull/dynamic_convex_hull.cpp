@@ -9,7 +9,7 @@
 #include <cg/io/point.h>
 
 #include <cg/primitives/point.h>
-#include <cg/convex_hull/naive_dynamic.h>
+#include <cg/convex_hull/dynamic.h>
 
 using cg::point_2f;
 using cg::point_2;
@@ -165,6 +165,6 @@ private:
 int main(int argc, char ** argv)
 {
    QApplication app(argc, argv);
-   dynamic_hull_viewer<cg::naive_dynamic_hull> viewer;
+   dynamic_hull_viewer<cg::dynamic_hull> viewer;
    cg::visualization::run_viewer(&viewer, "dynamic convex hull");
 }
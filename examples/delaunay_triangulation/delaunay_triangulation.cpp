@@ -51,14 +51,6 @@ struct delaunay_triangulation_viewer : cg::visualization::viewer_adapter
         return circle_2(center, radius);
     }
 
-    boost::optional<triangle_2> find_triangle(point_2 const &p) const
-    {
-        for (triangle_2 const &t : triangles)
-            if (contains(t, p))
-                return t;
-        return boost::none;
-    }
-
     void draw(cg::visualization::drawer_type & drawer) const
     {
         for (point_2 p : points)
@@ -69,15 +61,12 @@ struct delaunay_triangulation_viewer : cg::visualization::viewer_adapter
                 drawer.set_color(Qt::white);
             drawer.draw_point(p, 5);
         }
-        for (triangle_2 t : triangles)
-        {
-            drawer.set_color(Qt::green);
-            for (int j = 0; j < 3; ++j)
-                drawer.draw_line(t[j], t[(j + 1) % 3]);
-            drawer.set_color(Qt::gray);
-            if (auto st = find_triangle(cur_point))
-                drawer.draw_circle(get_circumcircle(*st));
-        }
+        drawer.set_color(Qt::green);
+        for (segment_2 const &s : triang.finite_edges())
+            drawer.draw_line(s[0], s[1]);
+        drawer.set_color(Qt::gray);
+        if (auto st = triang.locate(cur_point))
+            drawer.draw_circle(get_circumcircle(*st));
     }
 
     void print(cg::visualization::printer_type & p) const
@@ -93,13 +82,11 @@ struct delaunay_triangulation_viewer : cg::visualization::viewer_adapter
         {
             triang.remove_point(*cur_vertex);
             points.erase(remove(points.begin(), points.end(), *cur_vertex), points.end());
-            triangles = triang.get_triangles();
             check_cur_vertex();
         }
         else
         {
             points.clear();
-            triangles.clear();
             triang.clear();
         }
         return true;
@@ -109,7 +96,6 @@ struct delaunay_triangulation_viewer : cg::visualization::viewer_adapter
     {
         points.push_back(p);
         triang.add_point(p);
-        triangles = triang.get_triangles();
         cur_vertex = p;
         return true;
     }
@@ -136,7 +122,6 @@ struct delaunay_triangulation_viewer : cg::visualization::viewer_adapter
 
 private:
     std::vector<point_2> points;
-    std::vector<triangle_2> triangles;
     triangulation<double> triang;
     point_2 cur_point;
     boost::optional<point_2> cur_vertex;
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cg/primitives/point.h>
+
+#include <cmath>
+#include <cstddef>
+
+namespace cg
+{
+   // error-free transformations of double operations (Shewchuk, "Adaptive precision floating-point
+   // arithmetic and fast robust geometric predicates"), x is the rounded result and y its rounding error
+   namespace exact
+   {
+      inline void fast_two_sum(double a, double b, double & x, double & y)
+      {
+         // |a| >= |b|
+         x = a + b;
+         y = b - (x - a);
+      }
+
+      inline void two_sum(double a, double b, double & x, double & y)
+      {
+         x = a + b;
+         double b_virtual = x - a;
+         double a_virtual = x - b_virtual;
+         y = (a - a_virtual) + (b - b_virtual);
+      }
+
+      inline void two_diff(double a, double b, double & x, double & y)
+      {
+         x = a - b;
+         double b_virtual = a - x;
+         double a_virtual = x + b_virtual;
+         y = (a - a_virtual) + (b_virtual - b);
+      }
+
+      // a = hi + lo, both halves have at most 26 significant bits
+      inline void split(double a, double & hi, double & lo)
+      {
+         const double splitter = 134217729.; // 2^27 + 1
+         double c = splitter * a;
+         hi = c - (c - a);
+         lo = a - hi;
+      }
+
+      inline void two_product(double a, double b, double & x, double & y)
+      {
+         x = a * b;
+         double ahi, alo, bhi, blo;
+         split(a, ahi, alo);
+         split(b, bhi, blo);
+         y = alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+      }
+
+      // the operations above are exact unless an intermediate result underflows or overflows,
+      // products of up to four coordinate differences stay in range for these coordinates
+      inline bool in_range(double x)
+      {
+         double m = fabs(x);
+         return m == 0 || (m > 1e-50 && m < 1e50);
+      }
+
+      inline bool in_range(point_2 const & p)
+      {
+         return in_range(p.x) && in_range(p.y);
+      }
+   }
+
+   // exact value as a sum of nonoverlapping doubles ordered by increasing magnitude, zero components
+   // are dropped, so the sign is the sign of the largest one; N bounds the number of components
+   template <size_t N>
+   struct expansion
+   {
+      double c[N];
+      size_t size;
+
+      expansion()
+         : size(0)
+      {}
+
+      int sign() const
+      {
+         return size == 0 ? 0 : (c[size - 1] > 0) - (c[size - 1] < 0);
+      }
+
+      template <size_t M>
+      void assign(expansion<M> const & e)
+      {
+         static_assert(M <= N, "expansion may not fit");
+         size = e.size;
+         for (size_t i = 0; i != size; ++i)
+            c[i] = e.c[i];
+      }
+
+      // adds b, the expansion must have room for one more component
+      void grow(double b)
+      {
+         double q = b;
+         size_t res = 0;
+         for (size_t i = 0; i != size; ++i)
+         {
+            double h;
+            exact::two_sum(q, c[i], q, h);
+            if (h != 0)
+               c[res++] = h;
+         }
+         if (q != 0)
+            c[res++] = q;
+         size = res;
+      }
+   };
+
+   inline expansion<2> difference(double a, double b)
+   {
+      expansion<2> res;
+      double x, y;
+      exact::two_diff(a, b, x, y);
+      if (y != 0)
+         res.c[res.size++] = y;
+      if (x != 0)
+         res.c[res.size++] = x;
+      return res;
+   }
+
+   template <size_t N>
+   expansion<N> operator - (expansion<N> e)
+   {
+      for (size_t i = 0; i != e.size; ++i)
+         e.c[i] = -e.c[i];
+      return e;
+   }
+
+   template <size_t N, size_t M>
+   expansion<N + M> operator + (expansion<N> const & e, expansion<M> const & f)
+   {
+      expansion<N + M> res;
+      res.assign(e);
+      for (size_t i = 0; i != f.size; ++i)
+         res.grow(f.c[i]);
+      return res;
+   }
+
+   template <size_t N, size_t M>
+   expansion<N + M> operator - (expansion<N> const & e, expansion<M> const & f)
+   {
+      expansion<N + M> res;
+      res.assign(e);
+      for (size_t i = 0; i != f.size; ++i)
+         res.grow(-f.c[i]);
+      return res;
+   }
+
+   template <size_t N>
+   expansion<2 * N> operator * (expansion<N> const & e, double b)
+   {
+      expansion<2 * N> res;
+      if (e.size == 0 || b == 0)
+         return res;
+
+      double q, h;
+      exact::two_product(e.c[0], b, q, h);
+      if (h != 0)
+         res.c[res.size++] = h;
+      for (size_t i = 1; i != e.size; ++i)
+      {
+         double p1, p0, sum;
+         exact::two_product(e.c[i], b, p1, p0);
+         exact::two_sum(q, p0, sum, h);
+         if (h != 0)
+            res.c[res.size++] = h;
+         exact::fast_two_sum(p1, sum, q, h);
+         if (h != 0)
+            res.c[res.size++] = h;
+      }
+      if (q != 0)
+         res.c[res.size++] = q;
+      return res;
+   }
+
+   template <size_t N, size_t M>
+   expansion<2 * N * M> operator * (expansion<N> const & e, expansion<M> const & f)
+   {
+      expansion<2 * N * M> res;
+      for (size_t i = 0; i != f.size; ++i)
+      {
+         expansion<2 * N> partial = e * f.c[i];
+         for (size_t j = 0; j != partial.size; ++j)
+            res.grow(partial.c[j]);
+      }
+      return res;
+   }
+}
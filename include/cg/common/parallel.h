@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <vector>
+
+namespace cg
+{
+   // sorts both halves of the range concurrently and merges them, splitting until there is a task per thread
+   template <class RandIter, class Compare>
+   void parallel_sort(RandIter begin, RandIter end, Compare cmp, size_t threads)
+   {
+      const std::ptrdiff_t sequential_cutoff = 1 << 12;
+
+      if (threads < 2 || end - begin < sequential_cutoff)
+      {
+         std::sort(begin, end, cmp);
+         return;
+      }
+
+      RandIter mid = begin + (end - begin) / 2;
+      std::future<void> left = std::async(std::launch::async, [=] { parallel_sort(begin, mid, cmp, threads - threads / 2); });
+      parallel_sort(mid, end, cmp, threads / 2);
+      left.get();
+      std::inplace_merge(begin, mid, end, cmp);
+   }
+
+   template <class RandIter>
+   void parallel_sort(RandIter begin, RandIter end, size_t threads)
+   {
+      parallel_sort(begin, end, std::less<typename std::iterator_traits<RandIter>::value_type>(), threads);
+   }
+
+   // runs f(0), ..., f(count - 1) concurrently, the last one on the calling thread
+   template <class F>
+   void parallel_for(size_t count, F f)
+   {
+      std::vector<std::future<void> > tasks;
+      for (size_t k = 0; k + 1 < count; ++k)
+         tasks.push_back(std::async(std::launch::async, [&f, k] { f(k); }));
+      if (count != 0)
+         f(count - 1);
+      for (std::future<void> & task : tasks)
+         task.get();
+   }
+
+   // the first greatest element, as std::max_element, with a chunk of the range per thread
+   template <class RandIter, class Compare>
+   RandIter parallel_max_element(RandIter begin, RandIter end, Compare cmp, size_t threads)
+   {
+      const std::ptrdiff_t sequential_cutoff = 1 << 15;
+
+      std::ptrdiff_t n = end - begin;
+      if (threads < 2 || n < sequential_cutoff)
+         return std::max_element(begin, end, cmp);
+
+      std::ptrdiff_t chunk = (n + threads - 1) / threads;
+      auto chunk_begin = [&](size_t k) { return std::min(n, std::ptrdiff_t(k) * chunk); };
+
+      std::vector<RandIter> best(threads, end);
+      parallel_for(threads, [&](size_t k)
+      {
+         if (chunk_begin(k) != n)
+            best[k] = std::max_element(begin + chunk_begin(k), begin + chunk_begin(k + 1), cmp);
+      });
+
+      // an earlier chunk wins the ties
+      RandIter res = best[0];
+      for (size_t k = 1; k != threads; ++k)
+         if (best[k] != end && cmp(*res, *best[k]))
+            res = best[k];
+      return res;
+   }
+
+   // stable partition through a buffer: every thread classifies a chunk of the range, then the chunks
+   // are scattered to their places in the buffer and copied back concurrently
+   template <class RandIter, class Predicate>
+   RandIter parallel_partition(RandIter begin, RandIter end, Predicate pred, size_t threads)
+   {
+      typedef typename std::iterator_traits<RandIter>::value_type value_type;
+      const std::ptrdiff_t sequential_cutoff = 1 << 15;
+
+      std::ptrdiff_t n = end - begin;
+      if (threads < 2 || n < sequential_cutoff)
+         return std::partition(begin, end, pred);
+
+      std::ptrdiff_t chunk = (n + threads - 1) / threads;
+      auto chunk_begin = [&](size_t k) { return std::min(n, std::ptrdiff_t(k) * chunk); };
+
+      std::vector<char> flags(n);
+      std::vector<std::ptrdiff_t> selected(threads + 1, 0);
+      parallel_for(threads, [&](size_t k)
+      {
+         std::ptrdiff_t count = 0;
+         for (std::ptrdiff_t i = chunk_begin(k); i != chunk_begin(k + 1); ++i)
+            count += flags[i] = bool(pred(begin[i]));
+         selected[k + 1] = count;
+      });
+      for (size_t k = 0; k != threads; ++k)
+         selected[k + 1] += selected[k];
+      std::ptrdiff_t total = selected[threads];
+
+      std::vector<value_type> buffer(n);
+      parallel_for(threads, [&](size_t k)
+      {
+         std::ptrdiff_t t = selected[k], f = total + chunk_begin(k) - selected[k];
+         for (std::ptrdiff_t i = chunk_begin(k); i != chunk_begin(k + 1); ++i)
+            buffer[flags[i] ? t++ : f++] = begin[i];
+      });
+      parallel_for(threads, [&](size_t k)
+      {
+         std::copy(buffer.begin() + chunk_begin(k), buffer.begin() + chunk_begin(k + 1), begin + chunk_begin(k));
+      });
+
+      return begin + total;
+   }
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// the filtered predicates count how many calls reach each of their stages when CG_PREDICATE_STATS is defined,
+// otherwise CG_PREDICATE_STAGE expands to nothing and the counters stay zero
+#ifdef CG_PREDICATE_STATS
+#define CG_PREDICATE_STAGE_N(predicate, stage, n) \
+   ::cg::predicate_stats::record(::cg::predicate_stats::predicate, ::cg::predicate_stats::stage, n)
+#else
+#define CG_PREDICATE_STAGE_N(predicate, stage, n) ((void)0)
+#endif
+
+#define CG_PREDICATE_STAGE(predicate, stage) CG_PREDICATE_STAGE_N(predicate, stage, 1)
+
+namespace cg
+{
+   namespace predicate_stats
+   {
+      enum predicate_t
+      {
+         orientation,
+         delaunay_criterion,
+         cmp_dist,
+         predicates_count
+      };
+
+      // every call reaches the filter stage, so its counter is the number of calls
+      enum stage_t
+      {
+         filter,
+         interval,
+         expansion,
+         rational,
+         stages_count
+      };
+
+      struct counts
+      {
+         std::uint64_t calls[predicates_count][stages_count];
+
+         counts()
+         {
+            for (size_t p = 0; p != predicates_count; ++p)
+               for (size_t s = 0; s != stages_count; ++s)
+                  calls[p][s] = 0;
+         }
+      };
+
+      // every thread increments its own counters, which only it writes, so the hot path is a relaxed
+      // load and store; the mutex guards the list of threads and is taken on thread start and exit,
+      // collect and reset only
+      struct thread_counts
+      {
+         std::atomic<std::uint64_t> calls[predicates_count][stages_count];
+
+         thread_counts();
+         ~thread_counts();
+      };
+
+      struct registry
+      {
+         std::mutex mutex;
+         std::vector<thread_counts *> threads;
+         // counts of the threads which have exited
+         counts retired;
+
+         static registry & instance()
+         {
+            static registry res;
+            return res;
+         }
+      };
+
+      inline thread_counts::thread_counts()
+      {
+         for (size_t p = 0; p != predicates_count; ++p)
+            for (size_t s = 0; s != stages_count; ++s)
+               calls[p][s].store(0, std::memory_order_relaxed);
+
+         registry & r = registry::instance();
+         std::lock_guard<std::mutex> lock(r.mutex);
+         r.threads.push_back(this);
+      }
+
+      inline thread_counts::~thread_counts()
+      {
+         registry & r = registry::instance();
+         std::lock_guard<std::mutex> lock(r.mutex);
+         for (size_t p = 0; p != predicates_count; ++p)
+            for (size_t s = 0; s != stages_count; ++s)
+               r.retired.calls[p][s] += calls[p][s].load(std::memory_order_relaxed);
+         for (size_t i = 0; i != r.threads.size(); ++i)
+         {
+            if (r.threads[i] == this)
+            {
+               r.threads[i] = r.threads.back();
+               r.threads.pop_back();
+               break;
+            }
+         }
+      }
+
+      inline void record(predicate_t predicate, stage_t stage, std::uint64_t n)
+      {
+         static thread_local thread_counts local;
+         std::atomic<std::uint64_t> & c = local.calls[predicate][stage];
+         c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+      }
+
+      // sum over all threads, exact once the other threads stop calling predicates
+      inline counts collect()
+      {
+         registry & r = registry::instance();
+         std::lock_guard<std::mutex> lock(r.mutex);
+         counts res = r.retired;
+         for (thread_counts const * t : r.threads)
+            for (size_t p = 0; p != predicates_count; ++p)
+               for (size_t s = 0; s != stages_count; ++s)
+                  res.calls[p][s] += t->calls[p][s].load(std::memory_order_relaxed);
+         return res;
+      }
+
+      // should not race with calls of the predicates, the increments of a running thread may be lost
+      inline void reset()
+      {
+         registry & r = registry::instance();
+         std::lock_guard<std::mutex> lock(r.mutex);
+         r.retired = counts();
+         for (thread_counts * t : r.threads)
+            for (size_t p = 0; p != predicates_count; ++p)
+               for (size_t s = 0; s != stages_count; ++s)
+                  t->calls[p][s].store(0, std::memory_order_relaxed);
+      }
+
+      // a line per predicate with the number of calls and the share of them which reached every later stage
+      inline void dump(std::ostream & out, counts const & c = collect())
+      {
+         const char * predicates[predicates_count] = {"orientation", "delaunay_criterion", "cmp_dist"};
+         std::ios::fmtflags flags = out.flags();
+         std::streamsize precision = out.precision();
+
+         for (size_t p = 0; p != predicates_count; ++p)
+         {
+            double calls = c.calls[p][filter] ? double(c.calls[p][filter]) : 1.;
+            out << std::left << std::setw(20) << predicates[p] << std::right
+                << std::setw(14) << c.calls[p][filter] << " calls" << std::fixed << std::setprecision(4)
+                << std::setw(10) << 100. * c.calls[p][interval] / calls << "% interval"
+                << std::setw(10) << 100. * c.calls[p][expansion] / calls << "% expansion"
+                << std::setw(10) << 100. * c.calls[p][rational] / calls << "% rational\n";
+         }
+         out.flags(flags);
+         out.precision(precision);
+      }
+   }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cg/primitives/point.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace cg
+{
+   // position of the cell (x, y) of the 2^16 x 2^16 grid along the hilbert curve
+   inline std::uint32_t hilbert_index(std::uint32_t x, std::uint32_t y)
+   {
+      const std::uint32_t n = 1u << 16;
+      std::uint32_t d = 0;
+      for (std::uint32_t s = n / 2; s > 0; s /= 2)
+      {
+         std::uint32_t rx = (x & s) != 0;
+         std::uint32_t ry = (y & s) != 0;
+         d += s * s * ((3 * rx) ^ ry);
+         // turn the quadrant so that the curve enters it at the origin
+         if (ry == 0)
+         {
+            if (rx == 1)
+            {
+               x = n - 1 - x;
+               y = n - 1 - y;
+            }
+            std::swap(x, y);
+         }
+      }
+      return d;
+   }
+
+   // orders points along the hilbert curve over their bounding box, so neighbours in the range are close in the plane
+   template <class RandIter>
+   void hilbert_sort(RandIter begin, RandIter end)
+   {
+      typedef typename std::iterator_traits<RandIter>::value_type point_type;
+
+      if (end - begin < 2)
+         return;
+
+      double x_min = begin->x, x_max = begin->x, y_min = begin->y, y_max = begin->y;
+      for (RandIter it = begin; it != end; ++it)
+      {
+         x_min = std::min<double>(x_min, it->x);
+         x_max = std::max<double>(x_max, it->x);
+         y_min = std::min<double>(y_min, it->y);
+         y_max = std::max<double>(y_max, it->y);
+      }
+      double scale = 65535. / std::max(std::max(x_max - x_min, y_max - y_min), 1e-300);
+
+      std::vector<std::pair<std::uint32_t, point_type> > keyed;
+      keyed.reserve(end - begin);
+      for (RandIter it = begin; it != end; ++it)
+      {
+         std::uint32_t x = static_cast<std::uint32_t>((it->x - x_min) * scale);
+         std::uint32_t y = static_cast<std::uint32_t>((it->y - y_min) * scale);
+         keyed.push_back(std::make_pair(hilbert_index(x, y), *it));
+      }
+      std::stable_sort(keyed.begin(), keyed.end(),
+                       [](std::pair<std::uint32_t, point_type> const & a, std::pair<std::uint32_t, point_type> const & b)
+                       {
+                          return a.first < b.first;
+                       });
+      for (size_t i = 0; i != keyed.size(); ++i)
+         begin[i] = keyed[i].second;
+   }
+
+   // biased randomized insertion order: random rounds of doubling size, every round sorted along the hilbert curve
+   template <class RandIter>
+   void brio_sort(RandIter begin, RandIter end)
+   {
+      const size_t smallest_round = 64;
+
+      std::mt19937 rng(0x5eed);
+      std::shuffle(begin, end, rng);
+      for (RandIter round_end = end; round_end != begin; )
+      {
+         size_t size = round_end - begin;
+         RandIter round_begin = size > smallest_round ? begin + size / 2 : begin;
+         hilbert_sort(round_begin, round_end);
+         round_end = round_begin;
+      }
+   }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+#include <cg/operations/orientation.h>
+
+namespace cg
+{
+   // Akl-Toussaint heuristic: the points strictly inside the octagon of the extreme points in the directions
+   // x, y, x + y and x - y are not vertices of the hull. Moves the remaining points to the front of the range
+   // and returns their end, the points which can not be dropped for certain are kept
+   template <class RandIter>
+   RandIter akl_toussaint_filter(RandIter begin, RandIter end)
+   {
+      typedef typename std::iterator_traits<RandIter>::value_type point_type;
+
+      if (end - begin < 9)
+         return end;
+
+      // counterclockwise from the leftmost point
+      RandIter extreme[8];
+      std::fill(extreme, extreme + 8, begin);
+      for (RandIter it = begin; it != end; ++it)
+      {
+         double x = it->x, y = it->y;
+         if (x < extreme[0]->x) extreme[0] = it;
+         if (x + y < extreme[1]->x + extreme[1]->y) extreme[1] = it;
+         if (y < extreme[2]->y) extreme[2] = it;
+         if (x - y > extreme[3]->x - extreme[3]->y) extreme[3] = it;
+         if (x > extreme[4]->x) extreme[4] = it;
+         if (x + y > extreme[5]->x + extreme[5]->y) extreme[5] = it;
+         if (y > extreme[6]->y) extreme[6] = it;
+         if (x - y < extreme[7]->x - extreme[7]->y) extreme[7] = it;
+      }
+
+      // the octagon without repeated vertices, as lines p + t d
+      double px[8], py[8], dx[8], dy[8];
+      size_t sides = 0;
+      for (size_t l = 0; l != 8; ++l)
+      {
+         point_type const & a = *extreme[l];
+         point_type const & b = *extreme[(l + 1) % 8];
+         if (a == b)
+            continue;
+         px[sides] = a.x;
+         py[sides] = a.y;
+         dx[sides] = double(b.x) - a.x;
+         dy[sides] = double(b.y) - a.y;
+         ++sides;
+      }
+      if (sides < 3)
+         return end;
+      // repeating a side keeps the test and lets the compiler unroll it
+      for (size_t l = sides; l != 8; ++l)
+      {
+         px[l] = px[0];
+         py[l] = py[0];
+         dx[l] = dx[0];
+         dy[l] = dy[0];
+      }
+
+      // semi-static error bound of the orientation over the bounding box, the points with an uncertain
+      // sign are kept
+      double max_abs = std::max(std::max(std::fabs(double(extreme[0]->x)), std::fabs(double(extreme[4]->x))),
+                                std::max(std::fabs(double(extreme[2]->y)), std::fabs(double(extreme[6]->y))));
+      typedef decltype(begin->x) scalar_type;
+      if (!fits_double_exactly<scalar_type>(max_abs))
+         return end;
+
+      double eps = orientation_semi_static(max_abs).error();
+      if (eps == std::numeric_limits<double>::infinity())
+         return end;
+
+      return std::partition(begin, end, [&](point_type const & q)
+      {
+         double x = q.x, y = q.y;
+         bool inside = true;
+         for (size_t l = 0; l != 8; ++l)
+            inside &= dx[l] * (y - py[l]) - dy[l] * (x - px[l]) > eps;
+         return !inside;
+      });
+   }
+
+   // hull of the points which pass the filter, for any of the hull functions
+   template <class RandIter, class Hull>
+   RandIter akl_toussaint_hull(RandIter begin, RandIter end, Hull hull)
+   {
+      return hull(begin, akl_toussaint_filter(begin, end));
+   }
+}
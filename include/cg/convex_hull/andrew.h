@@ -27,7 +27,9 @@ namespace cg
       if (p == q)
          return p;
 
-      RandIter m = std::partition(p, q, [t, pt] (point_2 const & a)
+      typedef typename std::iterator_traits<RandIter>::value_type point_type;
+
+      RandIter m = std::partition(p, q, [t, pt] (point_type const & a)
                                         { return orientation(*t, *pt, a) != CG_LEFT; }
                                  );
 
@@ -38,4 +40,33 @@ namespace cg
 
       return contour_graham_hull(t, q);
    }
+
+   // Andrew's monotone chains with the points sorted by x on several threads and every chain built from
+   // the chains of the chunks of the sorted range, the sort does not call orientation at all
+   template <class RandIter>
+   RandIter andrew_hull(RandIter p, RandIter q, size_t threads)
+   {
+      const std::ptrdiff_t sequential_cutoff = 1 << 15;
+
+      if (threads < 2 || q - p < sequential_cutoff)
+         return andrew_hull(p, q);
+
+      parallel_sort(p, q, threads);
+
+      size_t n = q - p;
+      std::vector<size_t> lower, upper;
+      parallel_for(2, [&](size_t k)
+      {
+         if (k == 0)
+            lower = hull_detail::parallel_chain(p, 0, n, std::vector<size_t>(), CG_LEFT, threads - threads / 2);
+         else
+            upper = hull_detail::parallel_chain(p, 0, n, std::vector<size_t>(), CG_RIGHT, threads / 2);
+      });
+
+      // counterclockwise: the lower chain from the smallest point, then the upper one back without its ends
+      if (upper.size() > 2)
+         lower.insert(lower.end(), upper.rbegin() + 1, upper.rend() - 1);
+      return hull_detail::place_hull(p, lower);
+   }
 }
+
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <cg/common/parallel.h>
+
+#include "andrew.h"
+#include "akl_toussaint.h"
+
+namespace cg
+{
+   // hulls of many small independent sets of points in the compressed sparse row layout: the points of
+   // the set i are points[offsets[i]], ..., points[offsets[i + 1] - 1]. The hull of the set i is written to
+   // hull_points[hull_offsets[i]], ... counterclockwise, as andrew_hull gives it. Every set is processed
+   // in place in one flat copy of the points, so the only allocations are the ones of the output vectors,
+   // and the sets are split between the threads in contiguous runs. The Akl-Toussaint filter drops most
+   // of the points of a set before its sort
+   template <class Point>
+   void batch_hull(std::vector<Point> const & points, std::vector<size_t> const & offsets,
+                   std::vector<Point> & hull_points, std::vector<size_t> & hull_offsets, size_t threads = 1)
+   {
+      size_t sets = offsets.empty() ? 0 : offsets.size() - 1;
+
+      hull_points = points;
+      hull_offsets.assign(sets + 1, 0);
+
+      // the hull size of the set i goes to hull_offsets[i + 1] first
+      threads = std::max<size_t>(1, std::min(threads, sets));
+      size_t chunk = (sets + threads - 1) / threads;
+      typename std::vector<Point>::iterator begin = hull_points.begin();
+      parallel_for(threads, [&](size_t k)
+      {
+         for (size_t i = k * chunk; i < std::min(sets, (k + 1) * chunk); ++i)
+         {
+            typename std::vector<Point>::iterator b = begin + offsets[i], e = begin + offsets[i + 1];
+            hull_offsets[i + 1] = andrew_hull(b, akl_toussaint_filter(b, e)) - b;
+         }
+      });
+
+      // the hulls are at the starts of their sets, so moving them forward never overwrites one not moved yet;
+      // the ones before which no set shrank are in place already
+      for (size_t i = 0; i != sets; ++i)
+      {
+         size_t size = hull_offsets[i + 1];
+         hull_offsets[i + 1] = hull_offsets[i] + size;
+         if (hull_offsets[i] != offsets[i])
+            std::move(begin + offsets[i], begin + offsets[i] + size, begin + hull_offsets[i]);
+      }
+      hull_points.resize(hull_offsets[sets]);
+   }
+}
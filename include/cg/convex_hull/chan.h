@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <cg/operations/orientation.h>
+
+#include "graham.h"
+
+namespace cg
+{
+   namespace chan_detail
+   {
+      // b is a better next hull vertex after q than a: it is to the right of qa or farther on the same ray
+      template <class Point>
+      bool better(Point const & q, Point const & a, Point const & b)
+      {
+         if (b == q)
+            return false;
+         if (a == q)
+            return true;
+         switch (orientation(q, a, b))
+         {
+         case CG_RIGHT: return true;
+         case CG_LEFT: return false;
+         case CG_COLLINEAR: return collinear_are_ordered_along_line(q, a, b) && !(a == b);
+         }
+         return false;
+      }
+
+      // one round with groups of m points, fails if the hull has more than m vertices; the points which
+      // are not on the hulls of their groups are not on the hull either and are moved behind the new q
+      template <class RandIter>
+      bool wrap(RandIter p, RandIter & q, size_t m, std::vector<RandIter> & hull)
+      {
+         struct group
+         {
+            RandIter begin;
+            size_t size;
+            // the tangent point from the last hull vertex
+            size_t tangent;
+         };
+
+         std::vector<group> groups;
+         RandIter kept = p;
+         for (RandIter b = p; b != q; )
+         {
+            RandIter e = b + std::min<size_t>(m, q - b);
+            group g = {kept, size_t(graham_hull(b, e) - b), 0};
+            for (size_t i = 0; i != g.size; ++i)
+               std::iter_swap(kept++, b + i);
+            groups.push_back(g);
+            b = e;
+         }
+         q = kept;
+
+         RandIter start = p;
+         for (group const & g : groups)
+            if (*g.begin < *start)
+               start = g.begin;
+
+         hull.assign(1, start);
+         for (group & g : groups)
+            for (size_t i = 1; i != g.size; ++i)
+               if (better(*start, g.begin[g.tangent], g.begin[i]))
+                  g.tangent = i;
+
+         for (;;)
+         {
+            RandIter cur = hull.back();
+            RandIter next = cur;
+            for (group & g : groups)
+            {
+               // the tangent points turn counterclockwise together with the hull vertices, so it is
+               // enough to advance the one from the previous vertex
+               if (g.begin[g.tangent] == *cur)
+                  g.tangent = (g.tangent + 1) % g.size;
+               for (size_t k = 1; k < g.size; ++k)
+               {
+                  size_t t = (g.tangent + 1) % g.size;
+                  if (!better(*cur, g.begin[g.tangent], g.begin[t]))
+                     break;
+                  g.tangent = t;
+               }
+               if (better(*cur, *next, g.begin[g.tangent]))
+                  next = g.begin + g.tangent;
+            }
+
+            if (next == cur || *next == *start)
+               return true;
+            if (hull.size() == m)
+               return false;
+            hull.push_back(next);
+         }
+      }
+   }
+
+   // Chan's output-sensitive hull, O(n log h): hulls of groups of m points by graham_hull, then a gift
+   // wrapping which stops after m steps, with m = 64, 4096, ... until the hull fits. The first guess is
+   // larger than 4 of the paper as the rounds with tiny groups cost more than they save
+   template <class RandIter>
+   RandIter chan_hull(RandIter p, RandIter q)
+   {
+      typedef typename std::iterator_traits<RandIter>::value_type point_type;
+
+      std::vector<RandIter> hull;
+      for (size_t m = 64; m < size_t(q - p); m = std::min(m * m, size_t(q - p)))
+      {
+         if (!chan_detail::wrap(p, q, m, hull))
+            continue;
+
+         size_t n = q - p;
+
+         // the hull vertices to the front, in their order
+         std::vector<char> on_hull(n, 0);
+         std::vector<point_type> res;
+         res.reserve(n);
+         for (RandIter it : hull)
+         {
+            on_hull[it - p] = 1;
+            res.push_back(*it);
+         }
+         for (RandIter it = p; it != q; ++it)
+            if (!on_hull[it - p])
+               res.push_back(*it);
+         std::copy(res.begin(), res.end(), p);
+         return p + hull.size();
+      }
+      return graham_hull(p, q);
+   }
+}
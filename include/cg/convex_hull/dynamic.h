@@ -0,0 +1,505 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <boost/numeric/interval.hpp>
+#include <boost/optional.hpp>
+#include <gmpxx.h>
+
+#include <cg/primitives/point.h>
+#include <cg/operations/orientation.h>
+
+namespace cg
+{
+   typedef std::vector<point_2>::iterator vect_it;
+
+   namespace dynamic_hull_detail
+   {
+      // compares lexicographically the intersection of the lines a1 a2 and b1 b2, which are not parallel, with p
+      struct intersection_order_i
+      {
+         boost::optional<int> operator() (point_2 const & a1, point_2 const & a2, point_2 const & b1, point_2 const & b2,
+                                          point_2 const & p) const
+         {
+            typedef boost::numeric::interval_lib::unprotect<boost::numeric::interval<double> >::type interval;
+
+            boost::numeric::interval<double>::traits_type::rounding _;
+            interval dax = interval(a2.x) - a1.x, day = interval(a2.y) - a1.y;
+            interval dbx = interval(b2.x) - b1.x, dby = interval(b2.y) - b1.y;
+            interval d = dax * dby - day * dbx;
+            interval n = (interval(b1.x) - a1.x) * dby - (interval(b1.y) - a1.y) * dbx;
+            if (d.lower() <= 0 && d.upper() >= 0)
+               return boost::none;
+            int sd = d.lower() > 0 ? 1 : -1;
+
+            // the intersection is a1 + n / d (a2 - a1)
+            interval vx = (interval(a1.x) - p.x) * d + n * dax;
+            if (vx.lower() > 0)
+               return sd;
+            if (vx.upper() < 0)
+               return -sd;
+            if (vx.lower() != vx.upper())
+               return boost::none;
+
+            interval vy = (interval(a1.y) - p.y) * d + n * day;
+            if (vy.lower() > 0)
+               return sd;
+            if (vy.upper() < 0)
+               return -sd;
+            if (vy.lower() != vy.upper())
+               return boost::none;
+            return 0;
+         }
+      };
+
+      struct intersection_order_r
+      {
+         boost::optional<int> operator() (point_2 const & a1, point_2 const & a2, point_2 const & b1, point_2 const & b2,
+                                          point_2 const & p) const
+         {
+            mpq_class dax = mpq_class(a2.x) - a1.x, day = mpq_class(a2.y) - a1.y;
+            mpq_class dbx = mpq_class(b2.x) - b1.x, dby = mpq_class(b2.y) - b1.y;
+            mpq_class d = dax * dby - day * dbx;
+            mpq_class n = (mpq_class(b1.x) - a1.x) * dby - (mpq_class(b1.y) - a1.y) * dbx;
+            int sd = sgn(d);
+
+            int res = sgn(mpq_class((mpq_class(a1.x) - p.x) * d + n * dax));
+            if (res == 0)
+               res = sgn(mpq_class((mpq_class(a1.y) - p.y) * d + n * day));
+            return res * sd;
+         }
+      };
+
+      inline int intersection_order(point_2 const & a1, point_2 const & a2, point_2 const & b1, point_2 const & b2,
+                                    point_2 const & p)
+      {
+         if (boost::optional<int> v = intersection_order_i()(a1, a2, b1, b2, p))
+            return *v;
+
+         return *intersection_order_r()(a1, a2, b1, b2, p);
+      }
+   }
+
+   // Overmars - van Leeuwen hull: a weight-balanced tree with the points in its leaves in lexicographical
+   // order, every internal node keeps the bridges between the upper and the lower hulls of its children
+   // and the hull of a subtree is implied by the bridges below it. An update recomputes the bridges on
+   // one path, a bridge is found in O(log n) by a simultaneous descent into both children, so updates
+   // take O(log^2 n) amortized; the hull is reported in O(h log n)
+   struct dynamic_hull
+   {
+      dynamic_hull()
+         : root(npos)
+      {}
+
+      void add_point(point_2 p)
+      {
+         if (root == npos)
+         {
+            root = make_leaf(p);
+            return;
+         }
+
+         std::vector<index_t> path = find(p);
+         index_t u = path.back();
+         if (nodes[u].p == p)
+         {
+            ++nodes[u].count;
+            return;
+         }
+
+         index_t w = make_leaf(p);
+         index_t x = allocate();
+         nodes[x].child[0] = p < nodes[u].p ? w : u;
+         nodes[x].child[1] = p < nodes[u].p ? u : w;
+         replace(path, path.size() - 1, x);
+         path.back() = x;
+         path.push_back(w);
+         repair(path, p);
+      }
+
+      void remove_point(point_2 const & p)
+      {
+         if (root == npos)
+            return;
+
+         std::vector<index_t> path = find(p);
+         index_t u = path.back();
+         if (!(nodes[u].p == p))
+            return;
+         if (--nodes[u].count != 0)
+            return;
+
+         released.push_back(u);
+         if (path.size() == 1)
+         {
+            root = npos;
+            return;
+         }
+
+         index_t x = path[path.size() - 2];
+         index_t sibling = nodes[x].child[nodes[x].child[0] == u ? 1 : 0];
+         released.push_back(x);
+         replace(path, path.size() - 2, sibling);
+         path.resize(path.size() - 2);
+         path.push_back(sibling);
+         repair(path, p);
+      }
+
+      // counterclockwise from the lexicographically smallest point, without points in the middle of the edges
+      const std::pair<vect_it, vect_it> get_hull()
+      {
+         hull.clear();
+         if (root != npos)
+         {
+            std::vector<point_2> upper;
+            report(1, root, npos, npos, hull);
+            std::reverse(hull.begin(), hull.end());
+            report(0, root, npos, npos, upper);
+            if (upper.size() > 2)
+               hull.insert(hull.end(), upper.rbegin() + 1, upper.rend() - 1);
+         }
+         return std::pair<vect_it, vect_it>(hull.begin(), hull.end());
+      }
+
+      const std::pair<vect_it, vect_it> get_all_points()
+      {
+         points.clear();
+         if (root != npos)
+         {
+            std::vector<index_t> stack(1, root);
+            while (!stack.empty())
+            {
+               node const & v = nodes[stack.back()];
+               stack.pop_back();
+               if (v.child[0] == npos)
+                  points.insert(points.end(), v.count, v.p);
+               else
+               {
+                  stack.push_back(v.child[1]);
+                  stack.push_back(v.child[0]);
+               }
+            }
+         }
+         return std::pair<vect_it, vect_it>(points.begin(), points.end());
+      }
+
+   private:
+      typedef std::uint32_t index_t;
+      static const index_t npos = static_cast<index_t>(-1);
+
+      struct node
+      {
+         // both are npos for the leaves
+         index_t child[2];
+         // number of leaves
+         index_t size;
+         // the first leaf of the subtree in the order of side 0 (lexicographical) and of side 1 (reversed)
+         index_t ext[2];
+         // bridge[side] are the leaves joined by the upper (side 0) or the lower (side 1) hull, the first
+         // one is in child[side] and the second one in the other child
+         index_t bridge[2][2];
+         // the point of a leaf, the last point of child[0] for the internal nodes
+         point_2 p;
+         // leaves only, a point added several times is stored once
+         size_t count;
+      };
+
+      // part of the hull of a side of the subtree v between the leaves from and to, npos is unbounded
+      struct cursor
+      {
+         index_t v, from, to;
+      };
+
+      std::vector<node> nodes;
+      std::vector<index_t> released;
+      index_t root;
+      std::vector<point_2> hull, points;
+
+      index_t allocate()
+      {
+         if (!released.empty())
+         {
+            index_t res = released.back();
+            released.pop_back();
+            return res;
+         }
+         nodes.push_back(node());
+         return index_t(nodes.size() - 1);
+      }
+
+      index_t make_leaf(point_2 const & p)
+      {
+         index_t res = allocate();
+         node & v = nodes[res];
+         v.child[0] = v.child[1] = npos;
+         v.size = 1;
+         v.ext[0] = v.ext[1] = res;
+         v.p = p;
+         v.count = 1;
+         return res;
+      }
+
+      bool leaf(index_t v) const
+      {
+         return nodes[v].child[0] == npos;
+      }
+
+      point_2 const & pt(index_t leaf) const
+      {
+         return nodes[leaf].p;
+      }
+
+      // order of the points along the hulls of side
+      bool before(int side, index_t a, index_t b) const
+      {
+         return before(side, pt(a), pt(b));
+      }
+
+      static bool before(int side, point_2 const & a, point_2 const & b)
+      {
+         return side == 0 ? a < b : b < a;
+      }
+
+      // the path from the root to the leaf where p is or should be
+      std::vector<index_t> find(point_2 const & p) const
+      {
+         std::vector<index_t> path(1, root);
+         while (!leaf(path.back()))
+         {
+            node const & v = nodes[path.back()];
+            path.push_back(v.child[v.p < p ? 1 : 0]);
+         }
+         return path;
+      }
+
+      // puts the subtree x in place of path[k]
+      void replace(std::vector<index_t> const & path, size_t k, index_t x)
+      {
+         if (k == 0)
+            root = x;
+         else
+         {
+            node & parent = nodes[path[k - 1]];
+            parent.child[parent.child[0] == path[k] ? 0 : 1] = x;
+         }
+      }
+
+      // the nodes of the path above its last one have a changed subtree, p was added or removed there
+      void repair(std::vector<index_t> & path, point_2 const & p)
+      {
+         for (size_t k = path.size() - 1; k-- != 0; )
+            nodes[path[k]].size = nodes[nodes[path[k]].child[0]].size + nodes[nodes[path[k]].child[1]].size;
+
+         size_t top = path.size() - 1;
+         for (size_t k = 0; k + 1 != path.size(); ++k)
+         {
+            node const & v = nodes[path[k]];
+            // weight balance, a child holds at most 70% of the leaves
+            if (10 * std::max(nodes[v.child[0]].size, nodes[v.child[1]].size) > 7 * v.size)
+            {
+               index_t x = rebuild(path[k]);
+               replace(path, k, x);
+               path[k] = x;
+               top = k;
+               break;
+            }
+         }
+
+         // the hull of a side of a subtree changes only if p is on the hull of that side of the child on
+         // the path, before or after the update, and the bridges above an unchanged hull stay
+         bool changed[2] = {true, true};
+         for (size_t k = top; k-- != 0; )
+         {
+            node & v = nodes[path[k]];
+            v.ext[0] = nodes[v.child[0]].ext[0];
+            v.ext[1] = nodes[v.child[1]].ext[1];
+            v.p = pt(nodes[v.child[0]].ext[1]);
+            int c = v.child[0] == path[k + 1] ? 0 : 1;
+            for (int side = 0; side != 2; ++side)
+            {
+               if (!changed[side])
+                  continue;
+               index_t b0 = v.bridge[side][0], b1 = v.bridge[side][1];
+               find_bridge(side, path[k]);
+               if (v.bridge[side][0] != b0 || v.bridge[side][1] != b1)
+                  continue;
+               changed[side] = c == side ? !before(side, pt(b0), p) : !before(side, p, pt(b1));
+            }
+         }
+      }
+
+      index_t rebuild(index_t v)
+      {
+         std::vector<index_t> leaves, stack(1, v);
+         while (!stack.empty())
+         {
+            index_t u = stack.back();
+            stack.pop_back();
+            if (leaf(u))
+               leaves.push_back(u);
+            else
+            {
+               stack.push_back(nodes[u].child[1]);
+               stack.push_back(nodes[u].child[0]);
+               released.push_back(u);
+            }
+         }
+         return build(leaves, 0, leaves.size());
+      }
+
+      index_t build(std::vector<index_t> const & leaves, size_t lo, size_t hi)
+      {
+         if (hi - lo == 1)
+            return leaves[lo];
+
+         size_t mid = (lo + hi) / 2;
+         index_t l = build(leaves, lo, mid);
+         index_t r = build(leaves, mid, hi);
+         index_t res = allocate();
+         nodes[res].child[0] = l;
+         nodes[res].child[1] = r;
+         nodes[res].size = index_t(hi - lo);
+         update(res);
+         return res;
+      }
+
+      void update(index_t v)
+      {
+         node & n = nodes[v];
+         n.size = nodes[n.child[0]].size + nodes[n.child[1]].size;
+         n.ext[0] = nodes[n.child[0]].ext[0];
+         n.ext[1] = nodes[n.child[1]].ext[1];
+         n.p = pt(nodes[n.child[0]].ext[1]);
+         for (int side = 0; side != 2; ++side)
+            find_bridge(side, v);
+      }
+
+      // skips the nodes whose bridge is outside of the part of the hull, afterwards c.v is a leaf or
+      // both ends of its bridge are in the part
+      void normalize(int side, cursor & c) const
+      {
+         while (!leaf(c.v))
+         {
+            node const & v = nodes[c.v];
+            if (c.from != npos && before(side, v.bridge[side][0], c.from))
+               descend_second(side, c);
+            else if (c.to != npos && before(side, c.to, v.bridge[side][1]))
+               descend_first(side, c);
+            else
+               break;
+         }
+      }
+
+      // to the part of the hull up to the first end of the bridge
+      void descend_first(int side, cursor & c) const
+      {
+         node const & v = nodes[c.v];
+         if (c.to == npos || before(side, v.bridge[side][0], c.to))
+            c.to = v.bridge[side][0];
+         c.v = v.child[side];
+      }
+
+      // to the part of the hull from the second end of the bridge
+      void descend_second(int side, cursor & c) const
+      {
+         node const & v = nodes[c.v];
+         if (c.from == npos || before(side, c.from, v.bridge[side][1]))
+            c.from = v.bridge[side][1];
+         c.v = v.child[1 - side];
+      }
+
+      // the hulls of the children are separated, the points of the first one precede the second one along
+      // the hull; a and b go down to the ends of the bridge, every step discards the part of a hull before
+      // or after the bridge of the current node (Overmars and van Leeuwen)
+      void find_bridge(int side, index_t v)
+      {
+         node & n = nodes[v];
+         cursor a = {n.child[side], npos, npos};
+         cursor b = {n.child[1 - side], npos, npos};
+         // the last point of the first child
+         point_2 const & separator = pt(nodes[a.v].ext[1 - side]);
+
+         for (;;)
+         {
+            normalize(side, a);
+            normalize(side, b);
+            bool a_leaf = leaf(a.v), b_leaf = leaf(b.v);
+            if (a_leaf && b_leaf)
+               break;
+
+            if (a_leaf)
+            {
+               // the tangent from a point to the hull of b
+               index_t const * e = nodes[b.v].bridge[side];
+               if (orientation(pt(a.v), pt(e[0]), pt(e[1])) != CG_RIGHT)
+                  descend_second(side, b);
+               else
+                  descend_first(side, b);
+               continue;
+            }
+
+            if (b_leaf)
+            {
+               index_t const * e = nodes[a.v].bridge[side];
+               if (orientation(pt(e[0]), pt(e[1]), pt(b.v)) != CG_RIGHT)
+                  descend_first(side, a);
+               else
+                  descend_second(side, a);
+               continue;
+            }
+
+            point_2 const & a1 = pt(nodes[a.v].bridge[side][0]), & a2 = pt(nodes[a.v].bridge[side][1]);
+            point_2 const & b1 = pt(nodes[b.v].bridge[side][0]), & b2 = pt(nodes[b.v].bridge[side][1]);
+
+            // a point of b on or above the line of the edge of a puts the bridge before the edge, and the
+            // other way around
+            bool a_first = orientation(a1, a2, b1) != CG_RIGHT || orientation(a1, a2, b2) != CG_RIGHT;
+            bool b_second = orientation(b1, b2, a1) != CG_RIGHT || orientation(b1, b2, a2) != CG_RIGHT;
+            if (a_first)
+               descend_first(side, a);
+            if (b_second)
+               descend_second(side, b);
+            if (a_first || b_second)
+               continue;
+
+            // both edges are below the line of the other one, the lines cross between them; if they
+            // cross over a, the bridge is after the edge of a, otherwise before the edge of b
+            int order = dynamic_hull_detail::intersection_order(a1, a2, b1, b2, separator);
+            if (side == 0 ? order <= 0 : order >= 0)
+               descend_second(side, a);
+            else
+               descend_first(side, b);
+         }
+
+         n.bridge[side][0] = a.v;
+         n.bridge[side][1] = b.v;
+      }
+
+      // the points of the hull of side in the subtree v between the leaves from and to
+      void report(int side, index_t v, index_t from, index_t to, std::vector<point_2> & out) const
+      {
+         if (leaf(v))
+         {
+            out.push_back(pt(v));
+            return;
+         }
+
+         cursor c = {v, from, to};
+         normalize(side, c);
+         if (leaf(c.v))
+         {
+            out.push_back(pt(c.v));
+            return;
+         }
+
+         cursor first = c, second = c;
+         descend_first(side, first);
+         descend_second(side, second);
+         report(side, first.v, first.from, first.to, out);
+         report(side, second.v, second.from, second.to, out);
+      }
+   };
+}
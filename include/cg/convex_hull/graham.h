@@ -1,8 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
 
 #include <cg/operations/orientation.h>
+#include <cg/common/parallel.h>
 
 namespace cg
 {
@@ -64,7 +68,9 @@ namespace cg
       if (p == q)
          return p;
 
-      std::sort(p, q, [t] (point_2 const & a, point_2 const & b)
+      typedef typename std::iterator_traits<RandIter>::value_type point_type;
+
+      std::sort(p, q, [t] (point_type const & a, point_type const & b)
                         {
                            switch (orientation(*t, a, b))
                            {
@@ -77,4 +83,105 @@ namespace cg
 
       return contour_graham_hull(t, q);
    }
+
+   namespace hull_detail
+   {
+      // the stack of the Graham scan over the points of a range given by their positions: a point pops the
+      // vertices which do not make the turn with it, repeated points are skipped
+      template <class RandIter>
+      struct chain_scan
+      {
+         RandIter begin;
+         orientation_t turn;
+         std::vector<size_t> stack;
+
+         chain_scan(RandIter begin, orientation_t turn)
+            : begin(begin)
+            , turn(turn)
+         {}
+
+         void add(size_t i)
+         {
+            if (!stack.empty() && begin[stack.back()] == begin[i])
+               return;
+            while (stack.size() >= 2 && orientation(begin[stack[stack.size() - 2]], begin[stack.back()], begin[i]) != turn)
+               stack.pop_back();
+            stack.push_back(i);
+         }
+      };
+
+      // the scan over [first, last) of every chunk runs concurrently, a point which one of them drops is not
+      // on the hull of all the points, so the scan of the remaining ones gives the chain of the whole range
+      template <class RandIter>
+      std::vector<size_t> parallel_chain(RandIter begin, size_t first, size_t last, std::vector<size_t> const & head,
+                                         orientation_t turn, size_t threads)
+      {
+         size_t chunk = (last - first + threads - 1) / threads;
+         std::vector<std::vector<size_t> > chains(threads);
+         parallel_for(threads, [&](size_t k)
+         {
+            chain_scan<RandIter> scan(begin, turn);
+            for (size_t i : head)
+               scan.add(i);
+            for (size_t i = std::min(last, first + k * chunk); i < std::min(last, first + (k + 1) * chunk); ++i)
+               scan.add(i);
+            chains[k].assign(scan.stack.begin() + std::min(head.size(), scan.stack.size()), scan.stack.end());
+         });
+
+         chain_scan<RandIter> scan(begin, turn);
+         for (size_t i : head)
+            scan.add(i);
+         for (std::vector<size_t> const & chain : chains)
+            for (size_t i : chain)
+               scan.add(i);
+         return scan.stack;
+      }
+
+      // moves the points at the positions hull to the front of the range in the order of hull
+      template <class RandIter>
+      RandIter place_hull(RandIter begin, std::vector<size_t> const & hull)
+      {
+         typedef typename std::iterator_traits<RandIter>::value_type point_type;
+
+         std::vector<point_type> vertices;
+         for (size_t i : hull)
+            vertices.push_back(begin[i]);
+
+         // the k-th smallest position is at least k and the larger ones are not touched before their turn
+         std::vector<size_t> positions = hull;
+         std::sort(positions.begin(), positions.end());
+         for (size_t k = 0; k != positions.size(); ++k)
+            std::iter_swap(begin + k, begin + positions[k]);
+
+         return std::copy(vertices.begin(), vertices.end(), begin);
+      }
+   }
+
+   // graham_hull with the angular sort and the scan split between the threads
+   template <class RandIter>
+   RandIter graham_hull(RandIter p, RandIter q, size_t threads)
+   {
+      typedef typename std::iterator_traits<RandIter>::value_type point_type;
+      const std::ptrdiff_t sequential_cutoff = 1 << 15;
+
+      if (threads < 2 || q - p < sequential_cutoff)
+         return graham_hull(p, q);
+
+      std::iter_swap(p, parallel_max_element(p, q, std::greater<point_type>(), threads));
+      RandIter t = p;
+      parallel_sort(p + 1, q, [t] (point_type const & a, point_type const & b)
+                               {
+                                  switch (orientation(*t, a, b))
+                                  {
+                                  case CG_LEFT: return true;
+                                  case CG_RIGHT: return false;
+                                  case CG_COLLINEAR: return a < b;
+                                  }
+                                  return false;
+                               }, threads);
+
+      std::vector<size_t> hull = hull_detail::parallel_chain(p, 1, q - p, std::vector<size_t>(1, 0), CG_LEFT, threads);
+      return hull_detail::place_hull(p, hull);
+   }
 }
+
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <iterator>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <cg/primitives/point.h>
+#include <cg/operations/orientation.h>
+
+namespace cg
+{
+   typedef std::vector<point_2>::iterator vect_it;
+
+   // hull of a set of points which only grows: the upper and the lower chains in lexicographical order,
+   // as in andrew_hull, are kept in balanced trees. A point which becomes a vertex removes the vertices
+   // it hides, every point is removed at most once, so add_point takes O(log n) amortized time
+   struct incremental_hull
+   {
+      incremental_hull()
+         : upper(CG_RIGHT)
+         , lower(CG_LEFT)
+      {}
+
+      void add_point(point_2 const & p)
+      {
+         upper.add(p);
+         lower.add(p);
+      }
+
+      // the point is inside the hull or on its boundary, O(log n)
+      bool contains(point_2 const & p) const
+      {
+         return upper.contains(p) && lower.contains(p);
+      }
+
+      // counterclockwise from the lexicographically smallest point, without points in the middle of the edges
+      const std::pair<vect_it, vect_it> get_hull()
+      {
+         hull.assign(lower.points.begin(), lower.points.end());
+         if (upper.points.size() > 2)
+            hull.insert(hull.end(), std::next(upper.points.rbegin()), std::prev(upper.points.rend()));
+         return std::pair<vect_it, vect_it>(hull.begin(), hull.end());
+      }
+
+   private:
+      struct chain
+      {
+         // the turn of every three consecutive vertices, CG_RIGHT for the upper chain
+         orientation_t turn;
+         std::set<point_2> points;
+
+         explicit chain(orientation_t turn)
+            : turn(turn)
+         {}
+
+         // p is on the side of the chain where the hull is, or on the chain
+         bool contains(point_2 const & p) const
+         {
+            if (points.empty() || p < *points.begin() || *points.rbegin() < p)
+               return false;
+
+            std::set<point_2>::const_iterator next = points.lower_bound(p);
+            if (*next == p)
+               return true;
+            return orientation(*std::prev(next), *next, p) != -turn;
+         }
+
+         void add(point_2 const & p)
+         {
+            std::set<point_2>::iterator next = points.lower_bound(p);
+            if (next != points.end() && next != points.begin() && orientation(*std::prev(next), *next, p) != -turn)
+               return;
+            if (next != points.end() && *next == p)
+               return;
+
+            std::set<point_2>::iterator it = points.insert(next, p);
+            while (it != points.begin() && std::prev(it) != points.begin())
+            {
+               std::set<point_2>::iterator b = std::prev(it);
+               if (orientation(*std::prev(b), *b, p) == turn)
+                  break;
+               points.erase(b);
+            }
+            while (std::next(it) != points.end() && std::next(std::next(it)) != points.end())
+            {
+               std::set<point_2>::iterator b = std::next(it);
+               if (orientation(p, *b, *std::next(b)) == turn)
+                  break;
+               points.erase(b);
+            }
+         }
+      };
+
+      chain upper, lower;
+      std::vector<point_2> hull;
+   };
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include <cg/primitives/contour.h>
+#include <cg/operations/orientation.h>
+
+namespace cg
+{
+   namespace melkman_detail
+   {
+      // Melkman's deque: the hull of the vertices of a simple polyline added so far, counterclockwise from
+      // bottom to top, with the last added vertex at both ends. Every vertex is pushed and popped at most
+      // once on each end, so a polyline of n vertices takes O(n) time. The polyline must not intersect
+      // itself, otherwise the hull may be wrong
+      template <class Point>
+      struct deque
+      {
+         explicit deque(size_t size)
+            : d(2 * size + 3)
+            , bottom(size + 1)
+            , top(size)
+            , head(0)
+         {}
+
+         void add(Point const & v)
+         {
+            // the first vertices go to head until there are three of them which are not collinear
+            if (head < 2)
+            {
+               if (head == 0 || !(v == first[0]))
+                  first[head++] = v;
+               return;
+            }
+            if (head == 2)
+            {
+               switch (orientation(first[0], first[1], v))
+               {
+               case CG_COLLINEAR:
+                  // the polyline goes on along the line, a vertex back on it would be a self-intersection
+                  if (collinear_are_ordered_along_line(first[0], first[1], v))
+                     first[1] = v;
+                  return;
+               case CG_LEFT:
+                  push_top(first[0]);
+                  push_top(first[1]);
+                  break;
+               case CG_RIGHT:
+                  push_top(first[1]);
+                  push_top(first[0]);
+                  break;
+               }
+               push_top(v);
+               push_bottom(v);
+               head = 3;
+               return;
+            }
+
+            if (v == d[top] || (inside(d[top - 1], d[top], v) && inside(d[bottom], d[bottom + 1], v)))
+               return;
+
+            while (orientation(d[top - 1], d[top], v) != CG_LEFT)
+               --top;
+            push_top(v);
+            while (orientation(v, d[bottom], d[bottom + 1]) != CG_LEFT)
+               ++bottom;
+            push_bottom(v);
+         }
+
+         // counterclockwise from the lexicographically smallest vertex
+         template <class OutIter>
+         OutIter copy(OutIter out) const
+         {
+            if (head < 3)
+            {
+               // all the vertices are on a segment, it goes from its smaller end
+               if (head == 2 && first[1] < first[0])
+               {
+                  *out++ = first[1];
+                  *out++ = first[0];
+                  return out;
+               }
+               return std::copy(first, first + head, out);
+            }
+
+            typename std::vector<Point>::const_iterator b = d.begin() + bottom, e = d.begin() + top;
+            typename std::vector<Point>::const_iterator m = std::min_element(b, e);
+            return std::copy(b, m, std::copy(m, e, out));
+         }
+
+      private:
+         // v is to the left of the edge ab or on it
+         static bool inside(Point const & a, Point const & b, Point const & v)
+         {
+            switch (orientation(a, b, v))
+            {
+            case CG_LEFT: return true;
+            case CG_RIGHT: return false;
+            case CG_COLLINEAR: return collinear_are_ordered_along_line(a, v, b);
+            }
+            return false;
+         }
+
+         void push_top(Point const & v)
+         {
+            d[++top] = v;
+         }
+
+         void push_bottom(Point const & v)
+         {
+            d[--bottom] = v;
+         }
+
+         // both ends move by at most the number of vertices from the middle
+         std::vector<Point> d;
+         size_t bottom, top;
+         Point first[2];
+         size_t head;
+      };
+   }
+
+   // hull of a simple polyline in O(n) without sorting, writes the vertices counterclockwise from the
+   // lexicographically smallest one, without points in the middle of the edges
+   template <class BidIter, class OutIter>
+   OutIter melkman_hull(BidIter p, BidIter q, OutIter out)
+   {
+      typedef typename std::iterator_traits<BidIter>::value_type point_type;
+
+      melkman_detail::deque<point_type> hull(std::distance(p, q));
+      for (; p != q; ++p)
+         hull.add(*p);
+      return hull.copy(out);
+   }
+
+   // hull of a simple polygon, the contour is walked with its circulator from the smallest vertex
+   template <class Scalar>
+   contour_2t<Scalar> melkman_hull(contour_2t<Scalar> const & c)
+   {
+      melkman_detail::deque<point_2t<Scalar> > hull(c.size());
+      if (c.size() != 0)
+      {
+         typename contour_2t<Scalar>::circulator_t start = c.circulator(std::min_element(c.begin(), c.end()));
+         typename contour_2t<Scalar>::circulator_t it = start;
+         do
+            hull.add(*it++);
+         while (it != start);
+      }
+
+      std::vector<point_2t<Scalar> > res;
+      hull.copy(std::back_inserter(res));
+      return contour_2t<Scalar>(res);
+   }
+}
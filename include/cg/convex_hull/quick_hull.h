@@ -3,9 +3,12 @@
 #include <cg/primitives/point.h>
 #include <cg/primitives/vector.h>
 #include <cg/operations/orientation.h>
+#include <cg/common/parallel.h>
 #include <algorithm>
 #include <utility>
 #include <functional>
+#include <future>
+#include <iterator>
 
 namespace cg
 {
@@ -19,20 +22,28 @@ namespace cg
         return first2;
     }
 
+    // shorter ranges are not split between threads
+    const std::ptrdiff_t quick_hull_sequential_cutoff = 1 << 15;
+
+    // hull of the points [begin, end) to the right of the line from *begin to last_point, on several threads
+    // while the range is long enough: the scans are split between the threads and the two halves recurse concurrently
     template <class RanIter>
-    RanIter build_part(RanIter begin, RanIter end, point_2 const &last_point)
+    RanIter build_part(RanIter begin, RanIter end, typename std::iterator_traits<RanIter>::value_type const &last_point,
+                       size_t threads = 1)
     {
+        typedef typename std::iterator_traits<RanIter>::value_type point_type;
+
         if (begin + 1 == end)
         {
             return end;
         }
 
-        RanIter highest_point_iter = std::max_element(begin, end, [begin, &last_point](point_2 const &largest, point_2 const &first)
+        RanIter highest_point_iter = parallel_max_element(begin, end, [begin, &last_point](point_type const &largest, point_type const &first)
         {
                 return orientation(*begin, last_point, largest, first) == CG_RIGHT;
-        });
+        }, threads);
 
-        point_2 highest_point = *highest_point_iter;
+        point_type highest_point = *highest_point_iter;
 
         if (orientation(*begin, last_point, highest_point) == CG_COLLINEAR)
         {
@@ -40,25 +51,39 @@ namespace cg
         }
         std::iter_swap(begin + 1, highest_point_iter);
 
-        RanIter first = std::partition(begin + 2, end, [begin, &highest_point](point_2 const &point)
+        RanIter first = parallel_partition(begin + 2, end, [begin, &highest_point](point_type const &point)
         {
             return orientation(*begin, highest_point, point) == CG_RIGHT;
-        });
+        }, threads);
 
-        RanIter second = std::partition(first, end, [&highest_point, &last_point](point_2 const &point)
+        RanIter second = parallel_partition(first, end, [&highest_point, &last_point](point_type const &point)
         {
             return orientation(highest_point, last_point, point) == CG_RIGHT;
-        });
+        }, threads);
 
         std::iter_swap(begin + 1, first - 1);
 
-        RanIter first_end = build_part(begin, first - 1, highest_point);
-        RanIter second_end = build_part(first - 1, second, last_point);
+        RanIter first_end, second_end;
+        if (threads < 2 || second - begin < quick_hull_sequential_cutoff)
+        {
+            first_end = build_part(begin, first - 1, highest_point);
+            second_end = build_part(first - 1, second, last_point);
+        }
+        else
+        {
+            std::future<RanIter> left = std::async(std::launch::async, [&]
+            {
+                return build_part(begin, first - 1, highest_point, threads - threads / 2);
+            });
+            second_end = build_part(first - 1, second, last_point, threads / 2);
+            first_end = left.get();
+        }
         return swap_ranges(first - 1, second_end, first_end);
     }
 
+    // the hull does not depend on the number of threads
     template <class RanIter>
-    RanIter quick_hull(RanIter begin, RanIter end)
+    RanIter quick_hull(RanIter begin, RanIter end, size_t threads = 1)
     {
         if (begin == end)
         {
@@ -73,14 +98,36 @@ namespace cg
             return ++begin;
         }
 
-        RanIter bound = std::partition(begin + 1, end - 1, [begin, end](point_2 const &a)
+        typedef typename std::iterator_traits<RanIter>::value_type point_type;
+
+        // a small hull is cheaper than starting a thread
+        if (end - begin < quick_hull_sequential_cutoff)
+        {
+            threads = 1;
+        }
+
+        RanIter bound = parallel_partition(begin + 1, end - 1, [begin, end](point_type const &a)
         {
             return orientation(*begin, *(end - 1), a) == CG_RIGHT;
-        });
+        }, threads);
 
         std::iter_swap(end - 1, bound);
-        RanIter first = build_part(begin, bound, *bound);
-        RanIter second = build_part(bound, end, *begin);
+        RanIter first, second;
+        if (threads < 2)
+        {
+            first = build_part(begin, bound, *bound);
+            second = build_part(bound, end, *begin);
+        }
+        else
+        {
+            point_type lowest = *begin, highest = *bound;
+            std::future<RanIter> lower = std::async(std::launch::async, [&]
+            {
+                return build_part(begin, bound, highest, threads - threads / 2);
+            });
+            second = build_part(bound, end, lowest, threads / 2);
+            first = lower.get();
+        }
         return swap_ranges(bound, second, first);
     }
 }
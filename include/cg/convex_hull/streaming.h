@@ -0,0 +1,72 @@
+#pragma once
+
+#include <istream>
+#include <iterator>
+#include <vector>
+
+#include <cg/io/point.h>
+#include <cg/convex_hull/andrew.h>
+#include <cg/convex_hull/akl_toussaint.h>
+
+namespace cg
+{
+   // hull of a sequence of points which does not fit in memory: the points are collected in a buffer after
+   // the vertices of the current hull, and a full buffer is replaced by the hull of its contents, so only
+   // the hull and one chunk of points are kept at any time
+   template <class Point>
+   struct streaming_hull
+   {
+      explicit streaming_hull(size_t chunk_size = 1 << 20)
+         : chunk_size(chunk_size)
+         , hull_size(0)
+      {
+         buffer.reserve(chunk_size);
+      }
+
+      void add_point(Point const & p)
+      {
+         buffer.push_back(p);
+         if (buffer.size() - hull_size == chunk_size)
+            merge();
+      }
+
+      // any input iterators, such as istream iterators or pointers into a memory-mapped file
+      template <class InputIter>
+      void add_points(InputIter begin, InputIter end)
+      {
+         for (; begin != end; ++begin)
+            add_point(*begin);
+      }
+
+      // the hull of all the points added so far, counterclockwise
+      std::vector<Point> const & hull()
+      {
+         if (buffer.size() != hull_size)
+            merge();
+         return buffer;
+      }
+
+   private:
+      void merge()
+      {
+         typedef typename std::vector<Point>::iterator iter;
+         buffer.erase(akl_toussaint_hull(buffer.begin(), buffer.end(), [](iter b, iter e) { return andrew_hull(b, e); }),
+                      buffer.end());
+         hull_size = buffer.size();
+      }
+
+      size_t chunk_size;
+      std::vector<Point> buffer;
+      // the buffer starts with the vertices of the hull of the points merged before
+      size_t hull_size;
+   };
+
+   // hull of the points read from the stream in the format of cg/io/point.h, chunk_size points at a time
+   template <class Scalar>
+   std::vector<point_2t<Scalar> > streaming_hull_of(std::istream & in, size_t chunk_size = 1 << 20)
+   {
+      streaming_hull<point_2t<Scalar> > res(chunk_size);
+      res.add_points(std::istream_iterator<point_2t<Scalar> >(in), std::istream_iterator<point_2t<Scalar> >());
+      return res.hull();
+   }
+}
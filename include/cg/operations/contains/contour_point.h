@@ -13,7 +13,8 @@
 namespace cg
 {
    // c is convex contour ccw orientation
-   inline bool convex_contains(contour_2 const & c, point_2 const & q)
+   template<typename Scalar>
+   bool convex_contains(contour_2t<Scalar> const & c, point_2t<Scalar> const & q)
    {
       size_t cnt_vertices = c.size();
 
@@ -22,13 +23,13 @@ namespace cg
       if (cnt_vertices == 1)
          return c[0] == q;
       if (cnt_vertices == 2)
-         return cg::contains(cg::segment_2(c[0], c[1]), q);
+         return cg::contains(cg::segment_2t<Scalar>(c[0], c[1]), q);
 
       if (cg::orientation(c[0], c[1], q) == CG_RIGHT)
          return false;
 
-      contour_2::const_iterator it = std::lower_bound(c.begin() + 2, c.end(), q,
-         [&c] (point_2 const& a, point_2 const& b)
+      typename contour_2t<Scalar>::const_iterator it = std::lower_bound(c.begin() + 2, c.end(), q,
+         [&c] (point_2t<Scalar> const& a, point_2t<Scalar> const& b)
          {
             return cg::orientation(c[0], a, b) == cg::CG_LEFT;
          }
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <cg/primitives/contour.h>
+#include <cg/primitives/point.h>
+#include <cg/operations/orientation.h>
+#include <cg/operations/contains/contour_point.h>
+
+namespace cg
+{
+   // convex_contains for many points and one convex contour c, ccw orientation. The rays from c[0] to the
+   // other vertices and the edges are stored once as doubles in separate arrays, and a query is a binary
+   // search over the rays with a fixed number of steps and no branches on the data. The determinants are
+   // filtered with the semi-static bound of the bounding box of c, the points outside of it are outside
+   // of c and the ones which come close to a ray or an edge are passed to convex_contains
+   template <class Scalar>
+   struct prepared_convex_contour
+   {
+      explicit prepared_convex_contour(contour_2t<Scalar> const & c)
+         : contour_(c)
+         , eps_(std::numeric_limits<double>::infinity())
+      {
+         size_t n = c.size();
+         if (n < 3)
+            return;
+
+         min_x_ = max_x_ = c[0].x;
+         min_y_ = max_y_ = c[0].y;
+         for (size_t l = 1; l != n; ++l)
+         {
+            min_x_ = std::min<double>(min_x_, c[l].x);
+            max_x_ = std::max<double>(max_x_, c[l].x);
+            min_y_ = std::min<double>(min_y_, c[l].y);
+            max_y_ = std::max<double>(max_y_, c[l].y);
+         }
+
+         double max_abs = std::max(std::max(std::fabs(min_x_), std::fabs(max_x_)), std::max(std::fabs(min_y_), std::fabs(max_y_)));
+         if (!fits_double_exactly<Scalar>(max_abs))
+            return;
+         eps_ = orientation_semi_static(max_abs).error();
+
+         for (size_t l = 0; l != n; ++l)
+         {
+            size_t k = l + 1 == n ? 0 : l + 1;
+            vx_.push_back(c[l].x);
+            vy_.push_back(c[l].y);
+            ex_.push_back(double(c[k].x) - double(c[l].x));
+            ey_.push_back(double(c[k].y) - double(c[l].y));
+            rx_.push_back(double(c[l].x) - double(c[0].x));
+            ry_.push_back(double(c[l].y) - double(c[0].y));
+         }
+      }
+
+      bool contains(point_2t<Scalar> const & q) const
+      {
+         bool res;
+         contains(&q, &q + 1, &res);
+         return res;
+      }
+
+      // writes contains(q) for every q of the range to out, the queries go in blocks which take the steps
+      // of the search together
+      template <class InIter, class OutIter>
+      OutIter contains(InIter begin, InIter end, OutIter out) const
+      {
+         const size_t block = 8;
+         point_2t<Scalar> pts[block];
+         double x[block], y[block];
+         size_t ray[block];
+         bool inside[block], uncertain[block];
+
+         while (begin != end)
+         {
+            size_t size = 0;
+            for (; size != block && begin != end; ++begin, ++size)
+            {
+               pts[size] = *begin;
+               x[size] = pts[size].x;
+               y[size] = pts[size].y;
+            }
+
+            if (eps_ == std::numeric_limits<double>::infinity())
+            {
+               for (size_t k = 0; k != size; ++k)
+                  *out++ = convex_contains(contour_, pts[k]);
+               continue;
+            }
+
+            // q is in the bounding box and not to the right of the edge from c[0] to c[1]
+            for (size_t k = 0; k != size; ++k)
+            {
+               double d = det(rx_[1], ry_[1], x[k] - vx_[0], y[k] - vy_[0]);
+               inside[k] = (x[k] >= min_x_) & (x[k] <= max_x_) & (y[k] >= min_y_) & (y[k] <= max_y_) & (d >= -eps_);
+               uncertain[k] = std::fabs(d) <= eps_;
+               ray[k] = 2;
+            }
+
+            // the first ray from 2 to n - 1 which q is not strictly to the left of, n if there is none
+            for (size_t len = vx_.size() - 2; len > 1; )
+            {
+               size_t half = len / 2;
+               for (size_t k = 0; k != size; ++k)
+               {
+                  size_t r = ray[k] + half - 1;
+                  double d = det(rx_[r], ry_[r], x[k] - vx_[0], y[k] - vy_[0]);
+                  uncertain[k] |= std::fabs(d) <= eps_;
+                  ray[k] += (d > eps_) * half;
+               }
+               len -= half;
+            }
+            for (size_t k = 0; k != size; ++k)
+            {
+               size_t r = ray[k];
+               double d = det(rx_[r], ry_[r], x[k] - vx_[0], y[k] - vy_[0]);
+               uncertain[k] |= std::fabs(d) <= eps_;
+               ray[k] += d > eps_;
+            }
+
+            // q is not to the right of the edge from c[ray - 1] to c[ray]
+            for (size_t k = 0; k != size; ++k)
+            {
+               size_t e = ray[k] - 1;
+               double d = det(ex_[e], ey_[e], x[k] - vx_[e], y[k] - vy_[e]);
+               uncertain[k] |= std::fabs(d) <= eps_;
+               inside[k] &= (ray[k] != vx_.size()) & (d >= -eps_);
+            }
+
+            for (size_t k = 0; k != size; ++k)
+            {
+               // the points outside of the bounding box are certain whatever the determinants are
+               bool in_box = (x[k] >= min_x_) & (x[k] <= max_x_) & (y[k] >= min_y_) & (y[k] <= max_y_);
+               if (in_box && uncertain[k])
+                  *out++ = convex_contains(contour_, pts[k]);
+               else
+                  *out++ = inside[k];
+            }
+         }
+         return out;
+      }
+
+   private:
+      static double det(double ax, double ay, double bx, double by)
+      {
+         return ax * by - ay * bx;
+      }
+
+      contour_2t<Scalar> contour_;
+      double eps_;
+      double min_x_, max_x_, min_y_, max_y_;
+      // the vertices, the edges from every vertex to the next one and the rays from c[0] to the vertices
+      std::vector<double> vx_, vy_, ex_, ey_, rx_, ry_;
+   };
+
+   // contains for many points and one contour, ordinary or not: the band of the contour in y is cut into
+   // slabs of equal height and every slab keeps the edges which reach it, so a query looks only at the
+   // edges of its slab. An edge which crosses the whole slab is on the same side of the queries in y, those
+   // are sorted by x, so the ones to the right of the query are counted by a binary search and only the
+   // ones which overlap it in x are tested by orientation as in contains. The results are the same as the
+   // ones of contains, the points on the boundary included
+   template <class Scalar>
+   struct prepared_contour
+   {
+      explicit prepared_contour(contour_2t<Scalar> const & c)
+         : slabs_(1)
+         , min_y_(0)
+         , scale_(0)
+      {
+         size_t n = c.vertices_num();
+         ends_.offsets.assign(2, 0);
+         spans_.offsets.assign(2, 0);
+         if (n == 0)
+            return;
+
+         std::vector<edge> edges;
+         double max_y = c[0].y;
+         min_y_ = c[0].y;
+         for (size_t pr = n - 1, cur = 0; cur != n; pr = cur++)
+         {
+            edge e = {c[pr], c[cur], std::min(c[pr].x, c[cur].x), std::max(c[pr].x, c[cur].x)};
+            if (e.min_point.y > e.max_point.y)
+               std::swap(e.min_point, e.max_point);
+            edges.push_back(e);
+            min_y_ = std::min<double>(min_y_, c[cur].y);
+            max_y = std::max<double>(max_y, c[cur].y);
+         }
+
+         // a slab per edge, fewer if the long edges would be kept in too many slabs
+         for (slabs_ = n; ; slabs_ /= 2)
+         {
+            scale_ = slabs_ / (max_y - min_y_);
+            if (slabs_ == 1 || !(scale_ < std::numeric_limits<double>::infinity()))
+            {
+               slabs_ = 1;
+               scale_ = 0;
+               break;
+            }
+
+            size_t total = 0;
+            for (edge const & e : edges)
+               total += slab(e.max_point.y) - slab(e.min_point.y) + 1;
+            if (total <= 4 * n)
+               break;
+         }
+
+         // slab is monotone, so the slab of every y from min_point.y to max_point.y is between their slabs,
+         // and in the slabs strictly between them the edge is above and below every query
+         ends_.offsets.assign(slabs_ + 1, 0);
+         spans_.offsets.assign(slabs_ + 1, 0);
+         for (int pass = 0; pass != 2; ++pass)
+         {
+            for (edge const & e : edges)
+            {
+               for (size_t first = slab(e.min_point.y), last = slab(e.max_point.y), l = first; l <= last; ++l)
+               {
+                  slab_edges & to = l == first || l == last ? ends_ : spans_;
+                  if (pass == 0)
+                     ++to.offsets[l + 1];
+                  else
+                     to.edges[to.next[l]++] = e;
+               }
+            }
+            if (pass == 0)
+            {
+               ends_.allocate();
+               spans_.allocate();
+            }
+         }
+
+         // the spanning edges of a slab by min_x, with the greatest max_x up to every one of them
+         for (size_t l = 0; l != slabs_; ++l)
+         {
+            typename std::vector<edge>::iterator b = spans_.edges.begin() + spans_.offsets[l];
+            typename std::vector<edge>::iterator e = spans_.edges.begin() + spans_.offsets[l + 1];
+            std::sort(b, e, [](edge const & a, edge const & b) { return a.min_x < b.min_x; });
+         }
+         for (edge const & e : spans_.edges)
+         {
+            span_min_x_.push_back(e.min_x);
+            span_max_x_.push_back(e.max_x);
+         }
+         for (size_t l = 0; l != slabs_; ++l)
+            for (size_t k = spans_.offsets[l] + 1; k < spans_.offsets[l + 1]; ++k)
+               span_max_x_[k] = std::max(span_max_x_[k], span_max_x_[k - 1]);
+      }
+
+      bool contains(point_2t<Scalar> const & q) const
+      {
+         // below the contour, no edge reaches q.y
+         if (!(double(q.y) >= min_y_))
+            return false;
+
+         size_t l = slab(q.y);
+         size_t num_intersections = 0;
+         for (size_t k = ends_.offsets[l]; k != ends_.offsets[l + 1]; ++k)
+         {
+            edge const & e = ends_.edges[k];
+            if (q.y < e.min_point.y || q.y > e.max_point.y)
+               continue;
+
+            // q.y is in the band of the edge, the edge is to the right of q or to the left of it
+            if (q.x < e.min_x)
+            {
+               num_intersections += q.y < e.max_point.y;
+               continue;
+            }
+            if (q.x > e.max_x)
+               continue;
+
+            switch (test(e, q))
+            {
+            case CG_COLLINEAR: return true;
+            case CG_LEFT: num_intersections += q.y < e.max_point.y; break;
+            case CG_RIGHT: break;
+            }
+         }
+
+         // the spanning edges to the right of q, then back while the edges may reach q in x
+         size_t b = spans_.offsets[l];
+         size_t k = std::upper_bound(span_min_x_.begin() + b, span_min_x_.begin() + spans_.offsets[l + 1], q.x) - span_min_x_.begin();
+         num_intersections += spans_.offsets[l + 1] - k;
+         while (k-- != b && !(span_max_x_[k] < q.x))
+         {
+            edge const & e = spans_.edges[k];
+            if (q.x > e.max_x)
+               continue;
+
+            switch (test(e, q))
+            {
+            case CG_COLLINEAR: return true;
+            case CG_LEFT: num_intersections++; break;
+            case CG_RIGHT: break;
+            }
+         }
+
+         return num_intersections % 2;
+      }
+
+      template <class InIter, class OutIter>
+      OutIter contains(InIter begin, InIter end, OutIter out) const
+      {
+         for (; begin != end; ++begin)
+            *out++ = contains(*begin);
+         return out;
+      }
+
+   private:
+      // an edge with min_point.y <= max_point.y, as in contains
+      struct edge
+      {
+         point_2t<Scalar> min_point, max_point;
+         Scalar min_x, max_x;
+      };
+
+      // the edges of the slab l are edges[offsets[l]], ..., edges[offsets[l + 1] - 1]
+      struct slab_edges
+      {
+         std::vector<size_t> offsets;
+         std::vector<edge> edges;
+
+         // the positions of the next edges of the slabs while they are added
+         std::vector<size_t> next;
+
+         // offsets[l + 1] holds the number of the edges of the slab l
+         void allocate()
+         {
+            for (size_t l = 0; l + 1 != offsets.size(); ++l)
+               offsets[l + 1] += offsets[l];
+            edges.resize(offsets.back());
+            next.assign(offsets.begin(), offsets.end() - 1);
+         }
+      };
+
+      // CG_COLLINEAR if q is on the edge, the side of q otherwise
+      static orientation_t test(edge const & e, point_2t<Scalar> const & q)
+      {
+         orientation_t orient = orientation(e.min_point, e.max_point, q);
+         if (orient == CG_COLLINEAR && !(std::min(e.min_point, e.max_point) <= q && q <= std::max(e.min_point, e.max_point)))
+            return CG_RIGHT;
+         return orient;
+      }
+
+      size_t slab(double y) const
+      {
+         return size_t(std::min<double>(slabs_ - 1, (y - min_y_) * scale_));
+      }
+
+      size_t slabs_;
+      double min_y_, scale_;
+      // the edges with an end in the slab and the ones which cross it
+      slab_edges ends_, spans_;
+      // min_x of the spanning edges and the greatest max_x of the ones before in the slab
+      std::vector<Scalar> span_min_x_, span_max_x_;
+   };
+}
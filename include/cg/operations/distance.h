@@ -48,6 +48,19 @@ namespace cg
         }
     };
 
+    struct cmp_dist_e
+    {
+        boost::optional<bool> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+        {
+            if (!exact::in_range(a) || !exact::in_range(b) || !exact::in_range(c) || !exact::in_range(d))
+                return boost::none;
+
+            expansion<2> abx = difference(b.x, a.x), aby = difference(b.y, a.y);
+            expansion<2> cdx = difference(d.x, c.x), cdy = difference(d.y, c.y);
+            return ((cdx * cdx + cdy * cdy) - (abx * abx + aby * aby)).sign() > 0; // dist2 - dist1
+        }
+    };
+
     struct cmp_dist_r
     {
         boost::optional<bool> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
@@ -65,12 +78,19 @@ namespace cg
 
     inline bool cmp_dist(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
     {
+        CG_PREDICATE_STAGE(cmp_dist, filter);
         if (boost::optional<bool> v = cmp_dist_d()(a, b, c, d))
             return *v;
 
+        CG_PREDICATE_STAGE(cmp_dist, interval);
         if (boost::optional<bool> v = cmp_dist_i()(a, b, c, d))
             return *v;
 
-       return *cmp_dist_r()(a, b, c, d);
+        CG_PREDICATE_STAGE(cmp_dist, expansion);
+        if (boost::optional<bool> v = cmp_dist_e()(a, b, c, d))
+            return *v;
+
+        CG_PREDICATE_STAGE(cmp_dist, rational);
+        return *cmp_dist_r()(a, b, c, d);
     }
 }
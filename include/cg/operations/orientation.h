@@ -2,11 +2,19 @@
 
 #include "cg/primitives/point.h"
 #include "cg/primitives/contour.h"
+#include "cg/common/expansion.h"
+#include "cg/common/predicate_stats.h"
 #include <boost/numeric/interval.hpp>
 #include <gmpxx.h>
 
 #include <boost/optional.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
 namespace cg
 {
    enum orientation_t
@@ -26,20 +34,25 @@ namespace cg
 
    struct orientation_d
    {
-      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c) const
+      // CG_COLLINEAR when the sign is not certain
+      static orientation_t filter(point_2 const & a, point_2 const & b, point_2 const & c)
       {
          double l = (b.x - a.x) * (c.y - a.y);
          double r = (b.y - a.y) * (c.x - a.x);
          double res = l - r;
          double eps = (fabs(l) + fabs(r)) * 8 * std::numeric_limits<double>::epsilon();
 
-         if (res > eps)
-            return CG_LEFT;
+         return orientation_t((res > eps) - (res < -eps));
+      }
 
-         if (res < -eps)
-            return CG_RIGHT;
+      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c) const
+      {
+         orientation_t res = filter(a, b, c);
 
-         return boost::none;
+         if (res == CG_COLLINEAR)
+            return boost::none;
+
+         return res;
       }
 
       boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
@@ -102,6 +115,28 @@ namespace cg
       }
    };
 
+   // exact sign from floating-point expansions, fails only for coordinates near underflow or overflow
+   struct orientation_e
+   {
+      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c) const
+      {
+         if (!exact::in_range(a) || !exact::in_range(b) || !exact::in_range(c))
+            return boost::none;
+
+         return orientation_t((  difference(b.x, a.x) * difference(c.y, a.y)
+                               - difference(b.y, a.y) * difference(c.x, a.x)).sign());
+      }
+
+      boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+      {
+         if (!exact::in_range(a) || !exact::in_range(b) || !exact::in_range(c) || !exact::in_range(d))
+            return boost::none;
+
+         return orientation_t((  difference(b.x, a.x) * difference(d.y, c.y)
+                               - difference(b.y, a.y) * difference(d.x, c.x)).sign());
+      }
+   };
+
    struct orientation_r
    {
       boost::optional<orientation_t> operator() (point_2 const & a, point_2 const & b, point_2 const & c) const
@@ -137,45 +172,241 @@ namespace cg
       }
    };
 
-   inline orientation_t orientation(point_2 const & a, point_2 const & b, point_2 const & c)
+   // the stages after the double filter, for the points it left undecided
+   inline orientation_t orientation_after_filter(point_2 const & a, point_2 const & b, point_2 const & c)
    {
-      if (boost::optional<orientation_t> v = orientation_d()(a, b, c))
+      CG_PREDICATE_STAGE(orientation, interval);
+      if (boost::optional<orientation_t> v = orientation_i()(a, b, c))
          return *v;
 
-      if (boost::optional<orientation_t> v = orientation_i()(a, b, c))
+      CG_PREDICATE_STAGE(orientation, expansion);
+      if (boost::optional<orientation_t> v = orientation_e()(a, b, c))
          return *v;
 
+      CG_PREDICATE_STAGE(orientation, rational);
       return *orientation_r()(a, b, c);
    }
 
+   inline orientation_t orientation(point_2 const & a, point_2 const & b, point_2 const & c)
+   {
+      CG_PREDICATE_STAGE(orientation, filter);
+      orientation_t res = orientation_d::filter(a, b, c);
+      if (res != CG_COLLINEAR)
+         return res;
+
+      return orientation_after_filter(a, b, c);
+   }
+
+   // largest absolute value of a coordinate of the points
+   template <class Iter>
+   double max_abs_coordinate(Iter begin, Iter end)
+   {
+      double res = 0;
+      for (; begin != end; ++begin)
+         res = std::max(res, std::max(fabs(begin->x), fabs(begin->y)));
+      return res;
+   }
+
+   // semi-static filter: the error bound is computed once for a batch of points with |x|, |y| <= max_abs
+   // instead of on every call
+   struct orientation_semi_static
+   {
+      explicit orientation_semi_static(double max_abs)
+      {
+         // the differences of coordinates are at most 2 max_abs, the bound holds unless products underflow or overflow
+         if (max_abs > 1e-140 && max_abs < 1e140)
+            eps_ = 8.8872057372592798e-16 * 4 * max_abs * max_abs * (1 + 8 * std::numeric_limits<double>::epsilon());
+         else
+            eps_ = std::numeric_limits<double>::infinity();
+      }
+
+      template <class Iter>
+      orientation_semi_static(Iter begin, Iter end)
+         : orientation_semi_static(max_abs_coordinate(begin, end))
+      {}
+
+      // bound of the rounding error of the determinant, infinite when the filter can not decide
+      double error() const
+      {
+         return eps_;
+      }
+
+      // CG_COLLINEAR when the sign is not certain
+      orientation_t filter(point_2 const & a, point_2 const & b, point_2 const & c) const
+      {
+         double res = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+         return orientation_t((res > eps_) - (res < -eps_));
+      }
+
+      orientation_t operator() (point_2 const & a, point_2 const & b, point_2 const & c) const
+      {
+         CG_PREDICATE_STAGE(orientation, filter);
+         orientation_t res = filter(a, b, c);
+         if (res != CG_COLLINEAR)
+            return res;
+
+         return orientation_after_filter(a, b, c);
+      }
+
+   private:
+      double eps_;
+   };
+
    inline orientation_t orientation(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
    {
+      CG_PREDICATE_STAGE(orientation, filter);
       if (boost::optional<orientation_t> v = orientation_d()(a, b, c, d))
          return *v;
 
+      CG_PREDICATE_STAGE(orientation, interval);
       if (boost::optional<orientation_t> v = orientation_i()(a, b, c, d))
          return *v;
 
+      CG_PREDICATE_STAGE(orientation, expansion);
+      if (boost::optional<orientation_t> v = orientation_e()(a, b, c, d))
+         return *v;
+
+      CG_PREDICATE_STAGE(orientation, rational);
       return *orientation_r()(a, b, c, d);
    }
 
-   inline bool counterclockwise(contour_2 const & c)
+   // the coordinates of the type with absolute values up to max_abs convert to double exactly, so that
+   // the double filters apply to them
+   template <class Scalar>
+   bool fits_double_exactly(double max_abs)
+   {
+      const double two_to_53 = 9007199254740992.;
+      return std::numeric_limits<Scalar>::digits <= std::numeric_limits<double>::digits || max_abs < two_to_53;
+   }
+
+   // orientation kernels by coordinate type, selected at compile time: doubles go through the filtered
+   // stages, floats are widened to double in registers and integers are computed exactly in 128 bits
+   template <class Scalar, class Enable = void>
+   struct orientation_kernel;
+
+   template <>
+   struct orientation_kernel<double>
+   {
+      static orientation_t apply(point_2 const & a, point_2 const & b, point_2 const & c)
+      {
+         return orientation(a, b, c);
+      }
+
+      static orientation_t apply(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
+      {
+         return orientation(a, b, c, d);
+      }
+   };
+
+   // every float is a double, the stored points keep half the size
+   template <>
+   struct orientation_kernel<float>
+   {
+      static orientation_t apply(point_2f const & a, point_2f const & b, point_2f const & c)
+      {
+         point_2 da(a), db(b), dc(c);
+         CG_PREDICATE_STAGE(orientation, filter);
+         orientation_t res = orientation_d::filter(da, db, dc);
+         if (res != CG_COLLINEAR)
+            return res;
+
+         return orientation_after_filter(da, db, dc);
+      }
+
+      static orientation_t apply(point_2f const & a, point_2f const & b, point_2f const & c, point_2f const & d)
+      {
+         return orientation(point_2(a), point_2(b), point_2(c), point_2(d));
+      }
+   };
+
+   // exact without filters for signed coordinates. The differences of 64-bit ones below 2^62 in absolute
+   // value fit into 64 bits, larger ones are rare and are taken in expansions like orientation_e does
+   template <class Scalar>
+   struct orientation_kernel<Scalar, typename std::enable_if<std::is_integral<Scalar>::value>::type>
+   {
+      static_assert(std::is_signed<Scalar>::value, "the differences of unsigned coordinates wrap around");
+
+      static orientation_t apply(point_2t<Scalar> const & a, point_2t<Scalar> const & b, point_2t<Scalar> const & c)
+      {
+         return apply(a, b, a, c);
+      }
+
+      static orientation_t apply(point_2t<Scalar> const & a, point_2t<Scalar> const & b,
+                                 point_2t<Scalar> const & c, point_2t<Scalar> const & d)
+      {
+         if (!in_range(a) || !in_range(b) || !in_range(c) || !in_range(d))
+            return orientation_t((  (split(b.x) - split(a.x)) * (split(d.y) - split(c.y))
+                                  - (split(b.y) - split(a.y)) * (split(d.x) - split(c.x))).sign());
+
+         std::int64_t abx = std::int64_t(b.x) - a.x, aby = std::int64_t(b.y) - a.y;
+         std::int64_t cdx = std::int64_t(d.x) - c.x, cdy = std::int64_t(d.y) - c.y;
+#ifdef __SIZEOF_INT128__
+         __int128 res = __int128(abx) * cdy - __int128(aby) * cdx;
+
+         return orientation_t((res > 0) - (res < 0));
+#else
+         return determinant_sign(abx, cdy, aby, cdx);
+#endif
+      }
+
+      // sign of ad - bc by expansions, for the compilers without 128-bit integers
+      static orientation_t determinant_sign(std::int64_t a, std::int64_t d, std::int64_t b, std::int64_t c)
+      {
+         return orientation_t((split(a) * split(d) - split(b) * split(c)).sign());
+      }
+
+   private:
+      static bool in_range(point_2t<Scalar> const & p)
+      {
+         const std::int64_t bound = std::int64_t(1) << 62;
+         return std::int64_t(p.x) > -bound && std::int64_t(p.x) < bound && std::int64_t(p.y) > -bound && std::int64_t(p.y) < bound;
+      }
+
+      // the low 32 bits and the rest of v are exact in double
+      static expansion<2> split(std::int64_t v)
+      {
+         std::int64_t lo = v & std::int64_t(0xffffffff);
+         return difference(double(v - lo), -double(lo));
+      }
+   };
+
+   template <class Scalar>
+   orientation_t orientation(point_2t<Scalar> const & a, point_2t<Scalar> const & b, point_2t<Scalar> const & c)
+   {
+      return orientation_kernel<Scalar>::apply(a, b, c);
+   }
+
+   template <class Scalar>
+   orientation_t orientation(point_2t<Scalar> const & a, point_2t<Scalar> const & b, point_2t<Scalar> const & c, point_2t<Scalar> const & d)
+   {
+      return orientation_kernel<Scalar>::apply(a, b, c, d);
+   }
+
+   template <class Scalar>
+   bool counterclockwise(contour_2t<Scalar> const & c)
    {
       if (c.size() < 3) return true;
 
-      contour_2::const_iterator it_min_point = std::min_element(c.begin(), c.end());
+      typename contour_2t<Scalar>::const_iterator it_min_point = std::min_element(c.begin(), c.end());
 
-      point_2 min_point = *it_min_point;
+      point_2t<Scalar> min_point = *it_min_point;
 
-      contour_2::circulator_t it_prev = --c.circulator(it_min_point);
-      contour_2::circulator_t it_next = ++c.circulator(it_min_point);
+      typename contour_2t<Scalar>::circulator_t it_prev = --c.circulator(it_min_point);
+      typename contour_2t<Scalar>::circulator_t it_next = ++c.circulator(it_min_point);
 
-      point_2 prev = *it_prev;
-      point_2 next = *it_next;
+      point_2t<Scalar> prev = *it_prev;
+      point_2t<Scalar> next = *it_next;
 
       return orientation(prev, min_point, next) == CG_LEFT;
    }
 
+   // also takes the point vectors which convert to contour_2
+   inline bool counterclockwise(contour_2 const & c)
+   {
+      return counterclockwise<double>(c);
+   }
+
    template <class Scalar>
    bool collinear_are_ordered_along_line(point_2t<Scalar> const & a, point_2t<Scalar> const & b, point_2t<Scalar> const & c)
    {
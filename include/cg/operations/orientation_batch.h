@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cg/operations/orientation.h>
+
+#include <cstddef>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cg
+{
+   // out[i] = orientation(a, b, cs[i]); the double filter of orientation_d runs on 4 (AVX) or 2 (SSE2) points
+   // at once and only the points it leaves undecided go through the interval, expansion and rational stages
+   inline void orientation_batch(point_2 const & a, point_2 const & b, point_2 const * cs, size_t n, orientation_t * out)
+   {
+      static_assert(sizeof(point_2) == 2 * sizeof(double), "points are loaded as pairs of doubles");
+      CG_PREDICATE_STAGE_N(orientation, filter, n);
+
+      const double dx = b.x - a.x;
+      const double dy = b.y - a.y;
+      const double rel = 8 * std::numeric_limits<double>::epsilon();
+      size_t i = 0;
+
+#if defined(__AVX__)
+      {
+         const __m256d vdx = _mm256_set1_pd(dx), vdy = _mm256_set1_pd(dy);
+         const __m256d vax = _mm256_set1_pd(a.x), vay = _mm256_set1_pd(a.y);
+         const __m256d vrel = _mm256_set1_pd(rel), sign = _mm256_set1_pd(-0.);
+         // unpacking works within 128-bit lanes, bit k of the masks belongs to the point lane[k]
+         const size_t lane[4] = {0, 2, 1, 3};
+
+         for (; i + 4 <= n; i += 4)
+         {
+            __m256d p01 = _mm256_loadu_pd(&cs[i].x);
+            __m256d p23 = _mm256_loadu_pd(&cs[i + 2].x);
+            __m256d xs = _mm256_unpacklo_pd(p01, p23);
+            __m256d ys = _mm256_unpackhi_pd(p01, p23);
+
+            __m256d l = _mm256_mul_pd(vdx, _mm256_sub_pd(ys, vay));
+            __m256d r = _mm256_mul_pd(vdy, _mm256_sub_pd(xs, vax));
+            __m256d res = _mm256_sub_pd(l, r);
+            __m256d eps = _mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(sign, l), _mm256_andnot_pd(sign, r)), vrel);
+
+            int left = _mm256_movemask_pd(_mm256_cmp_pd(res, eps, _CMP_GT_OQ));
+            int right = _mm256_movemask_pd(_mm256_cmp_pd(res, _mm256_xor_pd(eps, sign), _CMP_LT_OQ));
+            for (size_t k = 0; k != 4; ++k)
+               out[i + lane[k]] = orientation_t(((left >> k) & 1) - ((right >> k) & 1));
+            if ((left | right) != 15)
+            {
+               for (size_t k = 0; k != 4; ++k)
+                  if (out[i + k] == CG_COLLINEAR)
+                     out[i + k] = orientation_after_filter(a, b, cs[i + k]);
+            }
+         }
+      }
+#elif defined(__SSE2__)
+      {
+         const __m128d vdx = _mm_set1_pd(dx), vdy = _mm_set1_pd(dy);
+         const __m128d vax = _mm_set1_pd(a.x), vay = _mm_set1_pd(a.y);
+         const __m128d vrel = _mm_set1_pd(rel), sign = _mm_set1_pd(-0.);
+
+         for (; i + 2 <= n; i += 2)
+         {
+            __m128d p0 = _mm_loadu_pd(&cs[i].x);
+            __m128d p1 = _mm_loadu_pd(&cs[i + 1].x);
+            __m128d xs = _mm_unpacklo_pd(p0, p1);
+            __m128d ys = _mm_unpackhi_pd(p0, p1);
+
+            __m128d l = _mm_mul_pd(vdx, _mm_sub_pd(ys, vay));
+            __m128d r = _mm_mul_pd(vdy, _mm_sub_pd(xs, vax));
+            __m128d res = _mm_sub_pd(l, r);
+            __m128d eps = _mm_mul_pd(_mm_add_pd(_mm_andnot_pd(sign, l), _mm_andnot_pd(sign, r)), vrel);
+
+            int left = _mm_movemask_pd(_mm_cmpgt_pd(res, eps));
+            int right = _mm_movemask_pd(_mm_cmplt_pd(res, _mm_xor_pd(eps, sign)));
+            out[i] = orientation_t((left & 1) - (right & 1));
+            out[i + 1] = orientation_t((left >> 1) - (right >> 1));
+            if ((left | right) != 3)
+            {
+               for (size_t k = 0; k != 2; ++k)
+                  if (out[i + k] == CG_COLLINEAR)
+                     out[i + k] = orientation_after_filter(a, b, cs[i + k]);
+            }
+         }
+      }
+#endif
+
+      for (; i != n; ++i)
+      {
+         orientation_t v = orientation_d::filter(a, b, cs[i]);
+         out[i] = v != CG_COLLINEAR ? v : orientation_after_filter(a, b, cs[i]);
+      }
+   }
+}
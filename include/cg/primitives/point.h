@@ -2,6 +2,9 @@
 
 #include "vector.h"
 
+#include <cstddef>
+#include <functional>
+
 namespace cg
 {
    template <class Scalar> struct point_2t;
@@ -110,3 +113,18 @@ namespace cg
       return res;
    }
 }
+
+namespace std
+{
+   // equal points hash equally, std::hash of a floating point type maps -0. and 0. together
+   template <class Scalar>
+   struct hash<cg::point_2t<Scalar> >
+   {
+      size_t operator () (cg::point_2t<Scalar> const & p) const
+      {
+         size_t hx = hash<Scalar>()(p.x);
+         size_t hy = hash<Scalar>()(p.y);
+         return hx ^ (hy + 0x9e3779b9 + (hx << 6) + (hx >> 2));
+      }
+   };
+}
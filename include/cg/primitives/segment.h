@@ -10,6 +10,7 @@ namespace cg
    template <class Scalar> struct segment_2t;
    typedef segment_2t<float> segment_2f;
    typedef segment_2t<double> segment_2;
+   typedef segment_2t<int> segment_2i;
 
    template <class Scalar>
    struct segment_2t
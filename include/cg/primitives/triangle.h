@@ -11,6 +11,7 @@ namespace cg
    struct triangle_2t;
 
    typedef triangle_2t<double> triangle_2;
+   typedef triangle_2t<int> triangle_2i;
 
    template <class Scalar>
    struct triangle_2t
@@ -1,9 +1,20 @@
 #pragma once
 #include <cg/operations/contains/triangle_point.h>
+#include <cg/common/spatial_sort.h>
 
 #include <vector>
 #include <algorithm>
-#include <memory>
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
 
 namespace cg
 {
@@ -12,14 +23,37 @@ namespace cg
     template <typename Scalar>
     class triangulation
     {
+        // nodes, edges and faces live in contiguous arenas and refer to each other by index
+        typedef std::uint32_t index_t;
+        static const index_t npos = static_cast<index_t>(-1);
+
+    public:
+        // the face the next walk starts from and the state of its random choices; const queries do not
+        // share one, so several threads may read the triangulation at the same time
+        struct locate_hint
+        {
+            index_t face;
+            std::uint32_t seed;
+
+            locate_hint()
+                : face(0)
+                , seed(2463534242u)
+            {}
+        };
+
+    private:
+
         struct node
         {
             point_2t<Scalar> p;
             bool infinite;
+            // any half-edge starting at the node
+            index_t e;
 
             node(point_2t<Scalar> p, bool infinite = false)
                 : p(p)
                 , infinite(infinite)
+                , e(npos)
             {}
 
             point_2t<Scalar> geometry() const
@@ -27,342 +61,936 @@ namespace cg
                 assert(!infinite);
                 return p;
             }
+        };
+
+        // half-edge a -> b, its face lies to the left
+        struct edge
+        {
+            index_t a, b;
+            index_t twin;
+            index_t next;
+            index_t f;
+
+            edge()
+                : a(npos), b(npos), twin(npos), next(npos), f(npos)
+            {}
+        };
+
+        struct face
+        {
+            index_t e;
+
+            face()
+                : e(npos)
+            {}
+        };
+
+        std::vector<node> nodes;
+        std::vector<edge> edges;
+        std::vector<face> faces;
+        // finite nodes by their exact coordinates
+        std::unordered_map<point_2t<Scalar>, index_t> index;
+
+        // coarse bucket grid over the points, every cell remembers a node inserted into it
+        struct jump_grid
+        {
+            double x, y, step;
+            size_t w, h;
+            std::vector<index_t> cells;
+            // the grid is rebuilt when the number of nodes reaches the capacity
+            size_t capacity;
+
+            jump_grid()
+                : x(0), y(0), step(1), w(0), h(0), capacity(0)
+            {}
+
+            index_t & operator[](point_2t<Scalar> const &p)
+            {
+                return cells[cell(p)];
+            }
+
+            index_t operator[](point_2t<Scalar> const &p) const
+            {
+                return cells.empty() ? npos : cells[cell(p)];
+            }
 
-            std::ostream & operator << (std::ostream & out)
+            size_t cell(point_2t<Scalar> const &p) const
             {
-                out << "(" << p.x << ", " << p.y << ")";
-                return out;
+                double cx = std::floor((double(p.x) - x) / step);
+                double cy = std::floor((double(p.y) - y) / step);
+                // clamped in double, a point far outside of the grid does not fit in size_t
+                size_t i = cx <= 0 ? 0 : cx >= double(w - 1) ? w - 1 : size_t(cx);
+                size_t j = cy <= 0 ? 0 : cy >= double(h - 1) ? h - 1 : size_t(cy);
+                return j * w + i;
             }
         };
 
-        struct face;
+        jump_grid grid;
+        // the hint of the walks of the updates
+        locate_hint hint;
 
-        struct edge
+        segment_2t<Scalar> edge_geometry(index_t e) const
         {
-            std::weak_ptr<node> a_, b_;
-            std::weak_ptr<edge> twin_;
-            std::weak_ptr<edge> next_;
-            std::weak_ptr<face> f_;
+            return segment_2t<Scalar>(nodes[edges[e].a].geometry(), nodes[edges[e].b].geometry());
+        }
 
-            std::shared_ptr<node> a() const { return a_.lock(); }
-            std::shared_ptr<node> b() const { return b_.lock(); }
-            std::shared_ptr<edge> twin() const { return twin_.lock(); }
-            std::shared_ptr<edge> next() const { return next_.lock(); }
-            std::shared_ptr<face> f() const { return f_.lock(); }
+        bool is_left(index_t e, point_2t<Scalar> const &p) const
+        {
+            assert(!nodes[edges[e].a].infinite && !nodes[edges[e].b].infinite);
+            segment_2t<Scalar> seg = edge_geometry(e);
+            orientation_t orient = orientation(seg[0], seg[1], p);
+            return (orient == CG_LEFT) || (orient == CG_COLLINEAR);
+        }
 
-            segment_2t<Scalar> geometry() const
+        bool edge_infinite(index_t e) const
+        {
+            return nodes[edges[e].a].infinite || nodes[edges[e].b].infinite;
+        }
+
+        void flip(index_t ab)
+        {
+            index_t ba = edges[ab].twin;
+            index_t bc = edges[ab].next;
+            index_t ca = edges[bc].next;
+            index_t ad = edges[ba].next;
+            index_t db = edges[ad].next;
+            index_t c = edges[bc].b;
+            index_t d = edges[ad].b;
+            index_t a = edges[ab].a;
+            index_t b = edges[ab].b;
+            index_t fab = edges[ab].f;
+            index_t fba = edges[ba].f;
+            if (nodes[a].e == ab)
+                nodes[a].e = ad;
+            if (nodes[b].e == ba)
+                nodes[b].e = bc;
+            edges[ab].a = d;
+            edges[ab].b = c;
+            edges[ab].next = ca;
+            edges[ca].next = ad;
+            edges[ad].next = ab;
+            edges[ad].f = fab;
+            edges[ba].a = c;
+            edges[ba].b = d;
+            edges[ba].next = db;
+            edges[db].next = bc;
+            edges[bc].next = ba;
+            edges[bc].f = fba;
+            faces[fab].e = ab;
+            faces[fba].e = ba;
+        }
+
+        bool bad(index_t e) const
+        {
+            index_t f = edges[e].f;
+            if (!face_infinite(f))
+            {
+                segment_2t<Scalar> seg = edge_geometry(e);
+                point_2t<Scalar> c = nodes[edges[edges[e].next].b].geometry();
+                orientation_t orient = orientation(seg[0], seg[1], c);
+                if (orient == CG_RIGHT)
+                    return true;
+                // degenerate face has to lose its longest side
+                if (orient == CG_COLLINEAR)
+                    return collinear_are_ordered_along_line(seg[0], c, seg[1]);
+            }
+            index_t opposite = edges[edges[edges[e].twin].next].b;
+            if (nodes[opposite].infinite)
+                return false;
+            if (face_infinite(f))
             {
-                return segment_2t<Scalar>(a()->geometry(), b()->geometry());
+                index_t ep = e;
+                while (edge_infinite(ep))
+                    ep = edges[ep].next;
+                segment_2t<Scalar> seg = edge_geometry(ep);
+                return orientation(seg[0], seg[1], nodes[opposite].geometry()) == CG_LEFT;
             }
+            else
+            {
+                segment_2t<Scalar> seg = edge_geometry(e);
+                point_2t<Scalar> c = nodes[edges[edges[e].next].b].geometry();
+                point_2t<Scalar> d = nodes[opposite].geometry();
+                if (delaunay_criterion(seg[0], seg[1], c, d))
+                    return false;
+                // the flip is only possible when the quadrangle is convex
+                return cg::opposite(orientation(c, d, seg[0]), orientation(c, d, seg[1]));
+            }
+        }
+
+        void check_criterion(index_t e)
+        {
+            if (bad(e))
+            {
+                flip(e);
+                check_criterion(edges[e].next);
+                check_criterion(edges[edges[e].next].next);
+                check_criterion(edges[edges[e].twin].next);
+                check_criterion(edges[edges[edges[e].twin].next].next);
+            }
+        }
 
-            bool is_left(std::shared_ptr<node> np) const
+        triangle_2t<Scalar> face_geometry(index_t f) const
+        {
+            index_t e = faces[f].e;
+            return triangle_2t<Scalar>(nodes[edges[e].a].geometry(),
+                                       nodes[edges[e].b].geometry(),
+                                       nodes[edges[edges[e].next].b].geometry());
+        }
+
+        bool face_contains(index_t f, point_2t<Scalar> const &p) const
+        {
+            index_t ep = faces[f].e;
+            if (face_infinite(f))
             {
-                assert(!a()->infinite && !b()->infinite);
-                if (np->infinite)
+                while (edge_infinite(ep))
+                    ep = edges[ep].next;
+                segment_2t<Scalar> seg = edge_geometry(ep);
+                orientation_t orient = orientation(seg[0], seg[1], p);
+                if (orient != CG_COLLINEAR)
+                    return orient == CG_LEFT;
+                // points on a hull edge belong to the finite side unless all the points are collinear
+                index_t twin = edges[ep].twin;
+                if (!face_infinite(edges[twin].f))
+                    return false;
+                if (collinear_are_ordered_along_line(seg[0], p, seg[1]))
                     return true;
-                segment_2t<Scalar> seg = geometry();
-                orientation_t orient = orientation(seg[0], seg[1], np->geometry());
-                return (orient == CG_LEFT) || (orient == CG_COLLINEAR);
+                // beyond the segment the point belongs to the faces at the end of the chain
+                if (collinear_are_ordered_along_line(seg[0], seg[1], p))
+                    return edges[edges[edges[ep].next].twin].f == edges[twin].f;
+                return edges[edges[edges[edges[ep].next].next].twin].f == edges[twin].f;
             }
+            for (int i = 0; i < 3; ++i)
+            {
+                if (!is_left(ep, p))
+                    return false;
+                ep = edges[ep].next;
+            }
+            return true;
+        }
 
-            bool infinite() const
+        bool face_infinite(index_t f) const
+        {
+            index_t ep = faces[f].e;
+            for (int i = 0; i < 3; ++i)
             {
-                return a()->infinite || b()->infinite;
+                if (nodes[edges[ep].a].infinite)
+                    return true;
+                ep = edges[ep].next;
             }
+            return false;
+        }
+
+        void make_face(index_t f, index_t e0, index_t e1, index_t e2)
+        {
+            edges[e0].next = e1;
+            edges[e1].next = e2;
+            edges[e2].next = e0;
+            edges[e0].f = edges[e1].f = edges[e2].f = f;
+            faces[f].e = e0;
+        }
 
-            void flip()
+        void make_twins(index_t e1, index_t e2)
+        {
+            edges[e1].twin = e2;
+            edges[e2].twin = e1;
+        }
+
+        void init()
+        {
+            if (nodes.size() != 2 || !edges.empty() || !faces.empty())
+                return;
+            nodes.push_back(node(point_2t<Scalar>(0, 0), true));
+            edges.resize(6);
+            faces.resize(2);
+            for (index_t i = 0; i < 3; ++i)
             {
-                std::shared_ptr<node> c = next()->b();
-                std::shared_ptr<node> d = twin()->next()->b();
-                std::shared_ptr<edge> ab = twin()->twin();
-                std::shared_ptr<edge> bc = ab->next();
-                std::shared_ptr<edge> ca = bc->next();
-                std::shared_ptr<edge> ba = twin();
-                std::shared_ptr<edge> ad = ba->next();
-                std::shared_ptr<edge> db = ad->next();
-                ab->a_ = d;
-                ab->b_ = c;
-                ab->next_ = ca;
-                ca->next_ = ad;
-                ad->next_ = ab;
-                ad->f_ = ab->f();
-                ba->a_ = c;
-                ba->b_ = d;
-                ba->next_ = db;
-                db->next_ = bc;
-                bc->next_ = ba;
-                bc->f_ = ba->f();
-                ab->f()->e_ = ab;
-                ba->f()->e_ = ba;
+                edges[i].a = i;
+                edges[i].b = (i + 1) % 3;
+                edges[3 + i].a = 2 - i;
+                edges[3 + i].b = 2 - (i + 1) % 3;
             }
+            make_face(0, 0, 1, 2);
+            make_face(1, 4, 5, 3);
+            make_twins(0, 4);
+            make_twins(1, 3);
+            make_twins(2, 5);
+            for (index_t i = 0; i < 3; ++i)
+                nodes[i].e = i;
+        }
 
-            bool bad() const
+        void insert_node_into_face(index_t n, index_t f)
+        {
+            index_t nf[3] = {f, index_t(faces.size()), index_t(faces.size() + 1)};
+            faces.resize(faces.size() + 2);
+            index_t to_n[3], from_n[3];
+            index_t ep = faces[f].e;
+            for (int i = 0; i < 3; ++i)
             {
-                if (!f()->infinite() && !is_left(next()->b()))
-                    return true;
-                if (twin()->next()->b()->infinite)
-                    return false;
-                if (f()->infinite())
-                {
-                    auto ep = twin()->twin();
-                    while (ep->infinite())
-                        ep = ep->next();
-                    return ep->is_left(twin()->next()->b());
-                }
-                else
+                index_t nep = edges[ep].next;
+                to_n[i] = edges.size();
+                from_n[i] = edges.size() + 1;
+                edges.resize(edges.size() + 2);
+                edges[to_n[i]].a = edges[ep].b;
+                edges[to_n[i]].b = n;
+                edges[from_n[i]].a = n;
+                edges[from_n[i]].b = edges[ep].a;
+                make_face(nf[i], ep, to_n[i], from_n[i]);
+                ep = nep;
+            }
+            for (int i = 0; i < 3; ++i)
+                make_twins(to_n[i], from_n[(i + 1) % 3]);
+            nodes[n].e = from_n[0];
+            // the longest side of a degenerate face may be one of the new edges
+            for (int i = 0; i < 3; ++i)
+            {
+                index_t a = edges[from_n[i]].b, b = edges[to_n[i]].a;
+                if (!nodes[a].infinite && !nodes[b].infinite
+                    && orientation(nodes[a].geometry(), nodes[b].geometry(), nodes[n].geometry()) == CG_COLLINEAR)
                 {
-                    triangle_2t<Scalar> tr = f()->geometry();
-                    return !delaunay_criterion(tr[0], tr[1], tr[2], twin()->next()->b()->geometry());
+                    check_criterion(to_n[i]);
+                    check_criterion(from_n[i]);
                 }
             }
+            for (int i = 2; i >= 0; --i)
+                check_criterion(faces[nf[i]].e);
+        }
 
-            void check_criterion()
+        // ear of the hole boundary which is a triangle of the resulting triangulation
+        size_t find_ear(std::vector<index_t> const &hole) const
+        {
+            size_t m = hole.size();
+            for (size_t i = 0; i < m; ++i)
             {
-                if (bad())
+                index_t x = edges[hole[i]].a;
+                index_t y = edges[hole[i]].b;
+                index_t z = edges[hole[(i + 1) % m]].b;
+                if (nodes[x].infinite || nodes[y].infinite || nodes[z].infinite)
+                    continue;
+                point_2t<Scalar> px = nodes[x].geometry(), py = nodes[y].geometry(), pz = nodes[z].geometry();
+                if (orientation(px, py, pz) != CG_LEFT)
+                    continue;
+                bool empty = true;
+                for (size_t j = (i + 3) % m; empty && j != i; j = (j + 1) % m)
                 {
-                    flip();
-                    next()->check_criterion();
-                    next()->next()->check_criterion();
-                    twin()->next()->check_criterion();
-                    twin()->next()->next()->check_criterion();
+                    index_t u = edges[hole[j]].a;
+                    if (!nodes[u].infinite && !delaunay_criterion(px, py, pz, nodes[u].geometry()))
+                        empty = false;
                 }
+                if (empty)
+                    return i;
             }
-        };
+            // no finite ear left: the rest of the hole is fanned around the infinite node,
+            // when it occurs twice all the points are collinear and the infinite node is the apex
+            size_t infinite = 0;
+            for (size_t i = 0; i < m; ++i)
+                infinite += nodes[edges[hole[i]].a].infinite;
+            for (size_t i = 0; i < m; ++i)
+                if (nodes[infinite > 1 ? edges[hole[i]].b : edges[hole[i]].a].infinite)
+                    return i;
+            return 0;
+        }
 
-        struct face
+        // the ear of the hole boundary at edges[hi].b becomes a face, hi is replaced by the new diagonal on the
+        // boundary and the opposite half-edge of the diagonal, which belongs to the face, is returned
+        index_t cut_ear(index_t &hi, index_t hj, std::vector<index_t> &free_edges, std::vector<index_t> &free_faces)
         {
-            std::weak_ptr<edge> e_;
-
-            std::shared_ptr<edge> e() const { return e_.lock(); }
+            index_t d = free_edges.back();
+            free_edges.pop_back();
+            index_t dt = free_edges.back();
+            free_edges.pop_back();
+            edges[d].a = edges[hj].b;
+            edges[d].b = edges[hi].a;
+            edges[dt].a = edges[hi].a;
+            edges[dt].b = edges[hj].b;
+            make_twins(d, dt);
+            make_face(free_faces.back(), hi, hj, d);
+            free_faces.pop_back();
+            hi = dt;
+            return d;
+        }
 
-            std::ostream & operator << (std::ostream & out)
+        // the finite faces around the removed point p form a fan. A finite ear at y of x, y, z is cut when it
+        // turns left and p is not to the right of xz: it lies in the faces pxy and pyz then, and the rest is a
+        // fan around p again. Inside the hull some ear is like that as long as the hole is not a triangle, as
+        // one of two disjoint ears does not contain p. On the hull the fan spans at most a half-turn, so every
+        // finite ear turning left may be cut, and when none is left the finite part of the hole is a convex
+        // chain which is fanned around the infinite node. The ears go in the order of the power of p to their
+        // circumcircle, the largest of which is Delaunay, so the criterion is rarely violated; the power is
+        // only a double, the exact predicates decide which ears may be cut. Each cut updates the two ears
+        // around it, so a hole of degree d takes O(d log d)
+        void fill_hole(point_2t<Scalar> const &p, std::vector<index_t> &hole, std::vector<index_t> &free_edges,
+                       std::vector<index_t> &free_faces, std::vector<index_t> &diagonals)
+        {
+            size_t m = hole.size();
+            std::vector<index_t> prev(m), next(m), version(m, 0);
+            for (size_t i = 0; i < m; ++i)
             {
-                out << *e()->a() << " " << *e()->b() << " " << *e()->next()->b();
-                return out;
+                prev[i] = index_t((i + m - 1) % m);
+                next[i] = index_t((i + 1) % m);
             }
 
-            triangle_2t<Scalar> geometry() const
+            // minus the power, version of the ear when it was pushed, position of the edge xy in the hole
+            typedef std::tuple<double, index_t, index_t> ear_t;
+            std::priority_queue<ear_t, std::vector<ear_t>, std::greater<ear_t> > ears;
+            auto push = [&](index_t i)
+            {
+                ++version[i];
+                if (nodes[edges[hole[i]].a].infinite || nodes[edges[hole[i]].b].infinite
+                    || nodes[edges[hole[next[i]]].b].infinite)
+                    return;
+                point_2t<Scalar> px = nodes[edges[hole[i]].a].geometry();
+                point_2t<Scalar> py = nodes[edges[hole[i]].b].geometry();
+                point_2t<Scalar> pz = nodes[edges[hole[next[i]]].b].geometry();
+                if (orientation(px, py, pz) != CG_LEFT || orientation(px, pz, p) == CG_RIGHT)
+                    return;
+                double ax = double(px.x) - double(p.x), ay = double(px.y) - double(p.y);
+                double bx = double(py.x) - double(p.x), by = double(py.y) - double(p.y);
+                double cx = double(pz.x) - double(p.x), cy = double(pz.y) - double(p.y);
+                double ab = ax * by - ay * bx, bc = bx * cy - by * cx, ca = cx * ay - cy * ax;
+                double lifted = (ax * ax + ay * ay) * bc + (bx * bx + by * by) * ca + (cx * cx + cy * cy) * ab;
+                ears.push(ear_t(lifted / (ab + bc + ca), version[i], i));
+            };
+            for (size_t i = 0; i < m; ++i)
+                push(index_t(i));
+
+            index_t live = 0;
+            while (m > 3 && !ears.empty())
             {
-                return triangle_2t<Scalar>(e()->a()->geometry(),
-                                           e()->b()->geometry(),
-                                           e()->next()->b()->geometry());
+                index_t i = std::get<2>(ears.top());
+                bool stale = std::get<1>(ears.top()) != version[i];
+                ears.pop();
+                if (stale)
+                    continue;
+                index_t j = next[i];
+                diagonals.push_back(cut_ear(hole[i], hole[j], free_edges, free_faces));
+                next[i] = next[j];
+                prev[next[j]] = i;
+                ++version[j];
+                push(i);
+                push(prev[i]);
+                live = i;
+                --m;
             }
 
-            bool contains(std::shared_ptr<node> np) const
+            // a convex chain is left of the hole of a hull node, unless all the points are collinear
+            index_t infinite = npos;
+            size_t infinite_count = 0;
+            index_t k = live;
+            do
             {
-                if (infinite())
+                if (nodes[edges[hole[k]].a].infinite)
                 {
-                    auto ep = e();
-                    while (ep->infinite())
-                        ep = ep->next();
-                    return ep->is_left(np);
+                    infinite = k;
+                    ++infinite_count;
                 }
-                auto ep = e();
-                for (int i = 0; i < 3; ++i)
+                k = next[k];
+            } while (k != live);
+            if (infinite_count == 1)
+            {
+                for (; m > 3; --m)
                 {
-                    if (!ep->is_left(np))
-                        return false;
-                    ep = ep->next();
+                    index_t j = next[infinite];
+                    diagonals.push_back(cut_ear(hole[infinite], hole[j], free_edges, free_faces));
+                    next[infinite] = next[j];
                 }
-                return true;
+                live = infinite;
             }
 
-            bool infinite() const
+            // find_ear finishes the rest of a degenerate hole
+            std::vector<index_t> rest;
+            k = live;
+            do
             {
-                auto ep = e();
-                for (int i = 0; i < 3; ++i)
-                {
-                    if (ep->a()->infinite)
-                        return true;
-                    ep = ep->next();
-                }
-                return false;
-            }
-        };
+                rest.push_back(hole[k]);
+                k = next[k];
+            } while (k != live);
+            hole.swap(rest);
+        }
 
-        std::vector<std::shared_ptr<node> > nodes;
-        std::vector<std::shared_ptr<edge> > edges;
-        std::vector<std::shared_ptr<face> > faces;
+        void move_edge(index_t from, index_t to)
+        {
+            edges[to] = edges[from];
+            edges[edges[to].twin].twin = to;
+            edges[edges[edges[to].next].next].next = to;
+            if (faces[edges[to].f].e == from)
+                faces[edges[to].f].e = to;
+            if (nodes[edges[to].a].e == from)
+                nodes[edges[to].a].e = to;
+        }
 
-        void init()
+        void move_face(index_t from, index_t to)
         {
-            if (nodes.size() != 2 || !edges.empty() || !faces.empty())
-                return;
-            auto np = std::shared_ptr<node>(new node(point_2t<Scalar>(0, 0), true));
-            nodes.push_back(np);
-            for (int i = 0; i < 6; ++i)
-                edges.push_back(std::shared_ptr<edge>(new edge()));
-            for (int i = 0; i < 2; ++i)
-                faces.push_back(std::shared_ptr<face>(new face()));
+            faces[to] = faces[from];
+            index_t ep = faces[to].e;
             for (int i = 0; i < 3; ++i)
             {
-                edges[i]->a_ = nodes[i];
-                edges[i]->b_ = nodes[(i + 1) % 3];
-                edges[i]->next_ = edges[(i + 1) % 3];
-                edges[i]->f_ = faces[0];
+                edges[ep].f = to;
+                ep = edges[ep].next;
+            }
+        }
+
+        // relabels the star of the node, the cells of the grid holding it move along
+        void move_node(index_t from, index_t to)
+        {
+            nodes[to] = nodes[from];
+            index_t spoke = nodes[to].e;
+            do
+            {
+                edges[spoke].a = to;
+                edges[edges[spoke].twin].b = to;
+                spoke = edges[edges[edges[spoke].next].next].twin;
+            } while (spoke != nodes[to].e);
+            if (!grid.cells.empty() && grid[nodes[to].p] == from)
+                grid[nodes[to].p] = to;
+            index[nodes[to].p] = to;
+        }
 
-                edges[3 + i]->a_ = *(nodes.rbegin() + i);
-                edges[3 + i]->b_ = *(nodes.rbegin() + (i + 1) % 3);
-                edges[3 + i]->next_ = edges[3 + (i + 1) % 3];
-                edges[3 + i]->f_ = faces[1];
+        // compacts the arenas by moving the last element into every released slot
+        void release(std::vector<index_t> released_edges, std::vector<index_t> released_faces)
+        {
+            std::sort(released_edges.begin(), released_edges.end(), std::greater<index_t>());
+            for (index_t e : released_edges)
+            {
+                if (e != edges.size() - 1)
+                    move_edge(edges.size() - 1, e);
+                edges.pop_back();
+            }
+            std::sort(released_faces.begin(), released_faces.end(), std::greater<index_t>());
+            for (index_t f : released_faces)
+            {
+                if (f != faces.size() - 1)
+                    move_face(faces.size() - 1, f);
+                faces.pop_back();
             }
-            edges[0]->twin_ = edges[4];
-            edges[4]->twin_ = edges[0];
-            edges[1]->twin_ = edges[3];
-            edges[3]->twin_ = edges[1];
-            edges[2]->twin_ = edges[5];
-            edges[5]->twin_ = edges[2];
-            faces[0]->e_ = edges[0];
-            faces[1]->e_ = edges[4];
         }
 
-        void insert_node_into_face(std::shared_ptr<node> np, std::shared_ptr<face> fp)
+        static std::uint32_t random(std::uint32_t &seed)
         {
-            std::shared_ptr<edge> ep = fp->e();
-            for (int i = 0; i < 3; ++i)
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            return seed;
+        }
+
+        index_t scan(point_2t<Scalar> const &p) const
+        {
+            for (index_t f = 0; f < faces.size(); ++f)
+                if (face_contains(f, p))
+                    return f;
+            return npos;
+        }
+
+        static double distance2(point_2t<Scalar> const &p, point_2t<Scalar> const &q)
+        {
+            double dx = double(p.x) - double(q.x);
+            double dy = double(p.y) - double(q.y);
+            return dx * dx + dy * dy;
+        }
+
+        void rebuild_grid()
+        {
+            double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+            bool first = true;
+            for (node const &np : nodes)
             {
-                std::shared_ptr<face> nfp(new face());
-                ep->f_ = nfp;
-                std::shared_ptr<edge> nep1(new edge());
-                nep1->a_ = ep->b();
-                nep1->b_ = np;
-                nep1->f_ = nfp;
-                std::shared_ptr<edge> nep2(new edge());
-                nep2->a_ = np;
-                nep2->b_ = ep->a();
-                nep2->f_ = nfp;
-                std::shared_ptr<edge> nep = ep->next();
-                ep->next_ = nep1;
-                nep1->next_ = nep2;
-                nep2->next_ = ep;
-
-                edges.push_back(nep1);
-                edges.push_back(nep2);
-                nfp->e_ = ep;
-                faces.push_back(nfp);
-                ep = nep;
+                if (np.infinite)
+                    continue;
+                double x = double(np.p.x), y = double(np.p.y);
+                x_min = first ? x : std::min(x_min, x);
+                x_max = first ? x : std::max(x_max, x);
+                y_min = first ? y : std::min(y_min, y);
+                y_max = first ? y : std::max(y_max, y);
+                first = false;
             }
-            for (int i = 0; i < 3; ++i)
+            // about two nodes per cell
+            double count = std::max<double>(1, nodes.size() / 2);
+            double dx = x_max - x_min, dy = y_max - y_min;
+            double step = (dx > 0 && dy > 0) ? std::sqrt(dx * dy / count) : std::max(dx, dy) / count;
+            grid.x = x_min;
+            grid.y = y_min;
+            grid.step = step > 0 ? step : 1;
+            grid.w = std::min<size_t>(size_t(dx / grid.step) + 1, 2 * size_t(count));
+            grid.h = std::min<size_t>(size_t(dy / grid.step) + 1, 2 * size_t(count));
+            grid.cells.assign(grid.w * grid.h, npos);
+            grid.capacity = std::max<size_t>(64, 2 * nodes.size());
+            for (index_t n = 0; n < nodes.size(); ++n)
+                if (!nodes[n].infinite)
+                    grid[nodes[n].p] = n;
+            // empty cells borrow a node from a neighbour in the row
+            for (size_t j = 0; j < grid.h; ++j)
             {
-                std::shared_ptr<face> fp1 = *(faces.rbegin() + (i + 1) % 3);
-                std::shared_ptr<face> fp2 = *(faces.rbegin() + i);
-                std::shared_ptr<edge> ep1 = fp1->e()->next();
-                std::shared_ptr<edge> ep2 = fp2->e()->next()->next();
-                ep1->twin_ = ep2;
-                ep2->twin_ = ep1;
+                index_t *row = &grid.cells[j * grid.w];
+                for (size_t i = 1; i < grid.w; ++i)
+                    if (row[i] == npos)
+                        row[i] = row[i - 1];
+                for (size_t i = grid.w - 1; i > 0; --i)
+                    if (row[i - 1] == npos)
+                        row[i - 1] = row[i];
             }
-            for (int i = 0; i < 3; ++i)
-                faces[faces.size() - i - 1]->e()->check_criterion();
+        }
+
+        // jump: the nearest of a node of the previous face and the node remembered by the grid
+        index_t start_face(point_2t<Scalar> const &p, locate_hint const &hint) const
+        {
+            index_t f = hint.face < faces.size() ? hint.face : 0;
+            index_t ep = faces[f].e;
+            while (nodes[edges[ep].a].infinite)
+                ep = edges[ep].next;
+            index_t best = edges[ep].a;
+            // cells may refer to nodes which were removed or moved since
+            index_t g = grid[p];
+            if (g < nodes.size() && !nodes[g].infinite && distance2(nodes[g].p, p) < distance2(nodes[best].p, p))
+                best = g;
+            return edges[nodes[best].e].f;
+        }
+
+        // walk: every step leaves the face through a randomly chosen edge which separates it from the point
+        index_t walk(index_t f, point_2t<Scalar> const &p, locate_hint &hint) const
+        {
+            if (face_infinite(f))
+            {
+                index_t ep = faces[f].e;
+                while (edge_infinite(ep))
+                    ep = edges[ep].next;
+                f = edges[edges[ep].twin].f;
+                // all the points are collinear
+                if (face_infinite(f))
+                    return scan(p);
+            }
+            // the edge the walk came through is known to have the point on its left
+            index_t entry = npos;
+            for (size_t steps = 0; steps <= faces.size(); ++steps)
+            {
+                index_t ep = faces[f].e;
+                for (std::uint32_t i = random(hint.seed) % 3; i != 0; --i)
+                    ep = edges[ep].next;
+                index_t exit = npos;
+                for (int i = 0; i < 3 && exit == npos; ++i)
+                {
+                    if (ep != entry
+                        && orientation(nodes[edges[ep].a].geometry(), nodes[edges[ep].b].geometry(), p) == CG_RIGHT)
+                        exit = ep;
+                    ep = edges[ep].next;
+                }
+                if (exit == npos)
+                    return f;
+                entry = edges[exit].twin;
+                f = edges[entry].f;
+                if (nodes[edges[edges[entry].next].b].infinite)
+                    return f;
+            }
+            return scan(p);
+        }
+
+        index_t locate_face(point_2t<Scalar> const &p, locate_hint &hint) const
+        {
+            if (faces.empty())
+                return npos;
+            hint.face = walk(start_face(p, hint), p, hint);
+            return hint.face;
+        }
+
+        // every finite edge is visited once by the half-edge with the smaller index
+        bool edge_skipped(index_t e) const
+        {
+            return edge_infinite(e) || edges[e].twin < e;
+        }
+
+        bool node_skipped(index_t n) const
+        {
+            return nodes[n].infinite;
+        }
+
+        point_2t<Scalar> node_geometry(index_t n) const
+        {
+            return nodes[n].p;
+        }
+
+        // the infinite node is created third and never moves, vertices after it are numbered one less outside
+        static index_t exported(index_t n)
+        {
+            return n > 2 ? n - 1 : n;
+        }
+
+        // visits the elements of an arena which are not skipped, dereferences to their geometry
+        template <class Value, bool (triangulation::*skipped)(index_t) const, Value (triangulation::*geometry)(index_t) const>
+        class element_iterator
+            : public boost::iterator_facade<element_iterator<Value, skipped, geometry>, Value, boost::forward_traversal_tag, Value>
+        {
+            friend class boost::iterator_core_access;
+            friend class triangulation;
+
+            triangulation const *tr;
+            index_t i, end;
+
+            element_iterator(triangulation const *tr, index_t i, index_t end)
+                : tr(tr), i(i), end(end)
+            {
+                settle();
+            }
+
+            void settle()
+            {
+                while (i != end && (tr->*skipped)(i))
+                    ++i;
+            }
+
+            void increment()
+            {
+                ++i;
+                settle();
+            }
+
+            bool equal(element_iterator const &other) const
+            {
+                return i == other.i;
+            }
+
+            Value dereference() const
+            {
+                return (tr->*geometry)(i);
+            }
+
+        public:
+            element_iterator()
+                : tr(nullptr), i(0), end(0)
+            {}
+        };
+
+        index_t find_node(point_2t<Scalar> const &p) const
+        {
+            typename std::unordered_map<point_2t<Scalar>, index_t>::const_iterator it = index.find(p);
+            return it == index.end() ? npos : it->second;
         }
 
     public:
+        // vertices are numbered densely, removing a vertex may renumber another one
+        typedef index_t vertex_handle;
+
+        triangulation()
+        {}
+
+        // builds the triangulation of the whole range at once, inserting the points
+        // in biased randomized order so that every walk starts next to its point
+        template <class Iter>
+        triangulation(Iter begin, Iter end)
+            : triangulation()
+        {
+            std::vector<point_2t<Scalar> > pts(begin, end);
+            std::sort(pts.begin(), pts.end());
+            pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+            brio_sort(pts.begin(), pts.end());
+
+            nodes.reserve(pts.size() + 1);
+            index.reserve(pts.size());
+            edges.reserve(6 * pts.size());
+            faces.reserve(2 * pts.size());
+            for (point_2t<Scalar> const &p : pts)
+                add_point(p);
+        }
+
         void clear()
         {
             nodes.clear();
             edges.clear();
             faces.clear();
+            index.clear();
+            grid = jump_grid();
+            hint = locate_hint();
         }
 
         void add_point(point_2t<Scalar> const &p)
         {
-            if (std::find_if(nodes.begin(), nodes.end(),
-                    [p] (std::shared_ptr<node> np) { return !np->infinite && np->geometry() == p; }) != nodes.end())
+            if (!index.insert(std::make_pair(p, index_t(nodes.size()))).second)
                 return;
-            std::shared_ptr<node> np(new node(p));
-            nodes.push_back(np);
-            if (nodes.size() < 3)
+            if (nodes.size() < 2)
             {
+                nodes.push_back(node(p));
                 if (nodes.size() == 2)
                     init();
                 return;
             }
-            auto f = std::find_if(faces.begin(), faces.end(),
-                         [np] (std::shared_ptr<face> f)
-                         {
-                             return f->contains(np);
-                         });
-            assert(f != faces.end());
-            std::shared_ptr<face> fp = *f;
-            *f = faces.back();
-            faces.pop_back();
-            insert_node_into_face(np, fp);
+            // the new node is not a part of the mesh until it is inserted, so it is located beforehand
+            index_t f = locate_face(p, hint);
+            assert(f != npos && face_contains(f, p));
+            nodes.push_back(node(p));
+            insert_node_into_face(nodes.size() - 1, f);
+            if (nodes.size() >= grid.capacity)
+                rebuild_grid();
+            else
+                grid[p] = nodes.size() - 1;
         }
 
+        // the hole of a node of degree d is filled in O(d log d), inside the hull or on it. The arenas are kept
+        // compact rather than threaded with free lists, as the ranges and the export walk them as arrays: the
+        // last node, edges and faces move into the released slots, which adds the degree of the last node
         void remove_point(point_2t<Scalar> const &p)
         {
-            auto npi = std::find_if(nodes.begin(), nodes.end(),
-                                    [p] (std::shared_ptr<node> np)
-                                    {
-                                        return !np->infinite && np->geometry() == p;
-                                    });
-            if (npi == nodes.end())
+            index_t n = find_node(p);
+            if (n == npos)
                 return;
-            std::shared_ptr<node> np = *npi;
-            *npi = nodes.back();
-            nodes.pop_back();
-            if (nodes.size() < 3)
+            index.erase(p);
+            if (nodes.size() < 4)
             {
-                if (nodes.size() == 2)
-                {
-                    node *n = 0;
-                    if (!nodes[0]->infinite)
-                        n = new node(nodes[0]->p);
-                    else
-                        n = new node(nodes[1]->p);
-                    clear();
-                    nodes.push_back(std::shared_ptr<node>(n));
-                }
+                std::vector<point_2t<Scalar> > rest;
+                for (node const &np : nodes)
+                    if (!np.infinite && np.p != p)
+                        rest.push_back(np.p);
+                clear();
+                for (point_2t<Scalar> const &q : rest)
+                    add_point(q);
                 return;
             }
-            std::vector<std::shared_ptr<edge> > edges_;
-            for (std::shared_ptr<edge> ep : edges)
-                if (ep->a() == np)
-                    edges_.push_back(ep);
-            assert(edges_.size() > 2);
-            for (int i = 0; i < edges_.size() - 3; ++i)
-                edges_[i]->flip();
-            std::shared_ptr<edge> ep;
-            if (edges_.size() > 3)
-                ep = edges_[edges_.size() - 4];
-            else
-                ep = edges_[0]->next();
-            auto ep1 = ep->next()->twin()->next();
-            auto ep2 = ep->next()->next()->twin()->next()->next();
-            faces.erase(std::remove_if(faces.begin(), faces.end(),
-                                        [ep1, ep2] (std::shared_ptr<face> fp) { return fp == ep1->f() || fp == ep2->f(); }),
-                        faces.end());
-            ep->next_ = ep1;
-            ep1->next_ = ep2;
-            ep2->next_ = ep;
-            ep1->f_ = ep->f();
-            ep2->f_ = ep->f();
-            ep->f()->e_ = ep;
-            edges.erase(std::remove_if(edges.begin(), edges.end(),
-                                        [np] (std::shared_ptr<edge> ep) { return ep->a() == np || ep->b() == np; }),
-                        edges.end());
-            for (int i = 3; i < edges_.size(); ++i)
-            {
-                auto ep = *(edges_.rbegin() + i);
-                if (ep->bad())
-                    ep->flip();
-            }
-            ep->check_criterion();
-            ep->next()->check_criterion();
-            ep->next()->next()->check_criterion();
-            for (int i = 0; i < edges_.size() - 3; ++i)
-                edges_[i]->check_criterion();
+
+            index_t first = nodes[n].e;
+
+            // star of the node in ccw order, its link is the boundary of the hole
+            std::vector<index_t> free_edges, free_faces, hole;
+            index_t spoke = first;
+            do
+            {
+                hole.push_back(edges[spoke].next);
+                free_edges.push_back(spoke);
+                free_edges.push_back(edges[spoke].twin);
+                free_faces.push_back(edges[spoke].f);
+                spoke = edges[edges[edges[spoke].next].next].twin;
+            } while (spoke != first);
+
+            for (index_t h : hole)
+                nodes[edges[h].a].e = h;
+            if (!grid.cells.empty() && grid[p] == n)
+            {
+                index_t h = hole[0];
+                grid[p] = nodes[edges[h].a].infinite ? edges[h].b : edges[h].a;
+            }
+
+            // end of a chain of collinear points, the hole degenerates into an edge
+            if (hole.size() == 2)
+            {
+                make_twins(edges[hole[0]].twin, edges[hole[1]].twin);
+                free_edges.insert(free_edges.end(), hole.begin(), hole.end());
+                nodes[edges[hole[0]].a].e = edges[hole[1]].twin;
+                nodes[edges[hole[1]].a].e = edges[hole[0]].twin;
+                hole.clear();
+            }
+
+            std::vector<index_t> diagonals;
+            if (!hole.empty())
+                fill_hole(p, hole, free_edges, free_faces, diagonals);
+            while (hole.size() > 3)
+            {
+                size_t i = find_ear(hole);
+                size_t j = (i + 1) % hole.size();
+                diagonals.push_back(cut_ear(hole[i], hole[j], free_edges, free_faces));
+                hole.erase(hole.begin() + j);
+            }
+            if (!hole.empty())
+            {
+                make_face(free_faces.back(), hole[0], hole[1], hole[2]);
+                free_faces.pop_back();
+            }
+
+            for (index_t d : diagonals)
+                check_criterion(d);
+
+            release(free_edges, free_faces);
+            if (n != nodes.size() - 1)
+                move_node(nodes.size() - 1, n);
+            nodes.pop_back();
+        }
+
+        bool contains_point(point_2t<Scalar> const &p) const
+        {
+            return index.count(p) != 0;
+        }
+
+        boost::optional<vertex_handle> find(point_2t<Scalar> const &p) const
+        {
+            index_t n = find_node(p);
+            if (n == npos)
+                return boost::none;
+            return n;
+        }
+
+        point_2t<Scalar> const & vertex(vertex_handle v) const
+        {
+            assert(!nodes[v].infinite);
+            return nodes[v].p;
+        }
+
+        // triangle which contains the point, none when the point is outside of the convex hull
+        boost::optional<triangle_2t<Scalar> > locate(point_2t<Scalar> const &p) const
+        {
+            locate_hint local;
+            return locate(p, local);
+        }
+
+        // the same with the walk starting from the face of the previous query of the hint, a sequence of
+        // close queries gets faster; every thread which locates points at the same time needs its own hint
+        boost::optional<triangle_2t<Scalar> > locate(point_2t<Scalar> const &p, locate_hint &hint) const
+        {
+            index_t f = locate_face(p, hint);
+            if (f == npos || face_infinite(f))
+                return boost::none;
+            return face_geometry(f);
+        }
+
+        typedef element_iterator<triangle_2t<Scalar>, &triangulation::face_infinite, &triangulation::face_geometry> face_iterator;
+        typedef element_iterator<segment_2t<Scalar>, &triangulation::edge_skipped, &triangulation::edge_geometry> edge_iterator;
+        typedef element_iterator<point_2t<Scalar>, &triangulation::node_skipped, &triangulation::node_geometry> vertex_iterator;
+
+        // lazy views of the mesh, invalidated by any update
+        boost::iterator_range<face_iterator> finite_faces() const
+        {
+            return boost::make_iterator_range(face_iterator(this, 0, faces.size()),
+                                              face_iterator(this, faces.size(), faces.size()));
+        }
+
+        boost::iterator_range<edge_iterator> finite_edges() const
+        {
+            return boost::make_iterator_range(edge_iterator(this, 0, edges.size()),
+                                              edge_iterator(this, edges.size(), edges.size()));
+        }
+
+        boost::iterator_range<vertex_iterator> vertices() const
+        {
+            return boost::make_iterator_range(vertex_iterator(this, 0, nodes.size()),
+                                              vertex_iterator(this, nodes.size(), nodes.size()));
+        }
+
+        // vertices in the order of vertices() and ccw triangles as triples of indices into them,
+        // the buffers are reused so that exporting every frame does not allocate
+        void export_indexed(std::vector<point_2t<Scalar> > &vertex_buffer,
+                            std::vector<std::array<std::uint32_t, 3> > &triangle_buffer) const
+        {
+            assert(nodes.size() < 3 || nodes[2].infinite);
+            vertex_buffer.assign(vertices().begin(), vertices().end());
+            triangle_buffer.clear();
+            for (index_t f = 0; f < faces.size(); ++f)
+            {
+                if (face_infinite(f))
+                    continue;
+                index_t e = faces[f].e;
+                std::array<std::uint32_t, 3> t = {{exported(edges[e].a),
+                                                   exported(edges[e].b),
+                                                   exported(edges[edges[e].next].b)}};
+                triangle_buffer.push_back(t);
+            }
         }
 
         std::vector<triangle_2t<Scalar> > get_triangles() const
         {
             std::vector<triangle_2t<Scalar> > res;
-            for (std::shared_ptr<face> f : faces)
-                if (!f->infinite())
-                    res.push_back(f->geometry());
+            for (index_t f = 0; f < faces.size(); ++f)
+                if (!face_infinite(f))
+                    res.push_back(face_geometry(f));
             return res;
         }
     };
 
+    template <typename Scalar>
+    const typename triangulation<Scalar>::index_t triangulation<Scalar>::npos;
+
     template <typename Scalar>
     Scalar determinant(Scalar a[3][3])
     {
@@ -387,8 +1015,20 @@ namespace cg
     {
         boost::optional<bool> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
         {
-            double res = delaunay_criterion_func<double>(a, b, c, d);
-            double eps = res * 16 * std::numeric_limits<double>::epsilon();
+            // in coordinates relative to d, the error is bounded by the permanent of the determinant (Shewchuk)
+            double adx = a.x - d.x, ady = a.y - d.y;
+            double bdx = b.x - d.x, bdy = b.y - d.y;
+            double cdx = c.x - d.x, cdy = c.y - d.y;
+            double alift = adx * adx + ady * ady;
+            double blift = bdx * bdx + bdy * bdy;
+            double clift = cdx * cdx + cdy * cdy;
+            double res =   alift * (bdx * cdy - cdx * bdy)
+                         + blift * (cdx * ady - adx * cdy)
+                         + clift * (adx * bdy - bdx * ady);
+            double permanent =   (fabs(bdx * cdy) + fabs(cdx * bdy)) * alift
+                               + (fabs(cdx * ady) + fabs(adx * cdy)) * blift
+                               + (fabs(adx * bdy) + fabs(bdx * ady)) * clift;
+            double eps = permanent * 12 * std::numeric_limits<double>::epsilon();
             if (res > eps)
                 return false;
 
@@ -422,6 +1062,24 @@ namespace cg
         }
     };
 
+    struct delaunay_criterion_e
+    {
+        boost::optional<bool> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
+        {
+            if (!exact::in_range(a) || !exact::in_range(b) || !exact::in_range(c) || !exact::in_range(d))
+                return boost::none;
+
+            expansion<2> adx = difference(a.x, d.x), ady = difference(a.y, d.y);
+            expansion<2> bdx = difference(b.x, d.x), bdy = difference(b.y, d.y);
+            expansion<2> cdx = difference(c.x, d.x), cdy = difference(c.y, d.y);
+            expansion<1536> res =   (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+                                  + (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy)
+                                  + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+
+            return res.sign() <= 0;
+        }
+    };
+
     struct delaunay_criterion_r
     {
         boost::optional<bool> operator() (point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d) const
@@ -436,12 +1094,19 @@ namespace cg
 
     inline bool delaunay_criterion(point_2 const & a, point_2 const & b, point_2 const & c, point_2 const & d)
     {
+        CG_PREDICATE_STAGE(delaunay_criterion, filter);
         if (boost::optional<bool> v = delaunay_criterion_d()(a, b, c, d))
             return *v;
 
+        CG_PREDICATE_STAGE(delaunay_criterion, interval);
         if (boost::optional<bool> v = delaunay_criterion_i()(a, b, c, d))
             return *v;
 
-       return *delaunay_criterion_r()(a, b, c, d);
+        CG_PREDICATE_STAGE(delaunay_criterion, expansion);
+        if (boost::optional<bool> v = delaunay_criterion_e()(a, b, c, d))
+            return *v;
+
+        CG_PREDICATE_STAGE(delaunay_criterion, rational);
+        return *delaunay_criterion_r()(a, b, c, d);
     }
 }
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <cg/triangulation/delaunay.h>
+#include <cg/common/parallel.h>
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <utility>
+
+namespace cg
+{
+    // Delaunay triangulation of a fixed set of points built by the Guibas-Stolfi divide and conquer
+    // in O(n log n) time, for batch jobs which do not update the triangulation afterwards
+    template <typename Scalar>
+    class static_triangulation
+    {
+        // quad-edges live in an arena, directed edge 4 * q + r is the quad-edge q rotated r times,
+        // even rotations are the edges of the triangulation and odd ones are the dual edges
+        typedef std::uint32_t index_t;
+        static const index_t npos = static_cast<index_t>(-1);
+
+        std::vector<point_2t<Scalar> > points;
+        // the error bound of the orientation filter is computed once for all the points
+        orientation_semi_static orient;
+        std::vector<index_t> next;
+        std::vector<index_t> origin;
+
+        // a triangulation of k points never has more than 3k edges, so the points [lo, hi) get the quads
+        // [12 lo, 12 hi) of the arena and the halves of the range can be triangulated concurrently
+        struct allocator
+        {
+            // ranges of quads which were never used and quads removed by the merges
+            std::vector<std::pair<index_t, index_t> > fresh;
+            std::vector<index_t> released;
+
+            index_t allocate()
+            {
+                if (!released.empty())
+                {
+                    index_t q = released.back();
+                    released.pop_back();
+                    return q;
+                }
+                assert(!fresh.empty());
+                index_t q = fresh.back().first;
+                fresh.back().first += 4;
+                if (fresh.back().first == fresh.back().second)
+                    fresh.pop_back();
+                return q;
+            }
+
+            // gives the upper part of the single fresh range to a new allocator
+            allocator split(index_t at)
+            {
+                assert(fresh.size() == 1 && released.empty());
+                allocator res;
+                res.fresh.push_back(std::make_pair(at, fresh.back().second));
+                fresh.back().second = at;
+                return res;
+            }
+
+            void join(allocator const &other)
+            {
+                fresh.insert(fresh.end(), other.fresh.begin(), other.fresh.end());
+                released.insert(released.end(), other.released.begin(), other.released.end());
+            }
+        };
+
+        static index_t region(index_t point)
+        {
+            return 4 * 3 * point;
+        }
+
+        static index_t rot(index_t e)
+        {
+            return (e & ~3u) | ((e + 1) & 3u);
+        }
+
+        static index_t rot_inv(index_t e)
+        {
+            return (e & ~3u) | ((e + 3) & 3u);
+        }
+
+        static index_t sym(index_t e)
+        {
+            return e ^ 2u;
+        }
+
+        index_t onext(index_t e) const
+        {
+            return next[e];
+        }
+
+        index_t oprev(index_t e) const
+        {
+            return rot(next[rot(e)]);
+        }
+
+        index_t lnext(index_t e) const
+        {
+            return rot(next[rot_inv(e)]);
+        }
+
+        index_t rprev(index_t e) const
+        {
+            return next[sym(e)];
+        }
+
+        index_t org(index_t e) const
+        {
+            return origin[e];
+        }
+
+        index_t dest(index_t e) const
+        {
+            return origin[sym(e)];
+        }
+
+        index_t make_edge(index_t a, index_t b, allocator &alloc)
+        {
+            index_t q = alloc.allocate();
+            next[q] = q;
+            next[q + 1] = q + 3;
+            next[q + 2] = q + 2;
+            next[q + 3] = q + 1;
+            origin[q] = a;
+            origin[q + 2] = b;
+            return q;
+        }
+
+        void splice(index_t a, index_t b)
+        {
+            index_t alpha = rot(next[a]);
+            index_t beta = rot(next[b]);
+            std::swap(next[a], next[b]);
+            std::swap(next[alpha], next[beta]);
+        }
+
+        index_t connect(index_t a, index_t b, allocator &alloc)
+        {
+            index_t e = make_edge(dest(a), org(b), alloc);
+            splice(e, lnext(a));
+            splice(sym(e), b);
+            return e;
+        }
+
+        void remove_edge(index_t e, allocator &alloc)
+        {
+            splice(e, oprev(e));
+            splice(sym(e), oprev(sym(e)));
+            index_t q = e & ~3u;
+            origin[q] = origin[q + 2] = npos;
+            alloc.released.push_back(q);
+        }
+
+        bool ccw(index_t a, index_t b, index_t c) const
+        {
+            return orient(points[a], points[b], points[c]) == CG_LEFT;
+        }
+
+        bool right_of(index_t x, index_t e) const
+        {
+            return ccw(x, dest(e), org(e));
+        }
+
+        bool left_of(index_t x, index_t e) const
+        {
+            return ccw(x, org(e), dest(e));
+        }
+
+        // d lies strictly inside the circle through the ccw triangle abc
+        bool in_circle(index_t a, index_t b, index_t c, index_t d) const
+        {
+            return !delaunay_criterion(points[a], points[b], points[c], points[d]);
+        }
+
+        // triangulates the sorted points [lo, hi), returns the ccw hull edge leaving the leftmost point
+        // and the cw hull edge leaving the rightmost one
+        std::pair<index_t, index_t> build(index_t lo, index_t hi, allocator &alloc, size_t threads)
+        {
+            const index_t sequential_cutoff = 1 << 12;
+
+            if (hi - lo == 2)
+            {
+                index_t a = make_edge(lo, lo + 1, alloc);
+                return std::make_pair(a, sym(a));
+            }
+            if (hi - lo == 3)
+            {
+                index_t a = make_edge(lo, lo + 1, alloc);
+                index_t b = make_edge(lo + 1, lo + 2, alloc);
+                splice(sym(a), b);
+                if (ccw(lo, lo + 1, lo + 2))
+                {
+                    connect(b, a, alloc);
+                    return std::make_pair(a, sym(b));
+                }
+                if (ccw(lo, lo + 2, lo + 1))
+                {
+                    index_t c = connect(b, a, alloc);
+                    return std::make_pair(sym(c), c);
+                }
+                return std::make_pair(a, sym(b));
+            }
+
+            index_t mid = lo + (hi - lo) / 2;
+            std::pair<index_t, index_t> left, right;
+            if (threads < 2 || hi - lo < sequential_cutoff)
+            {
+                left = build(lo, mid, alloc, 1);
+                right = build(mid, hi, alloc, 1);
+            }
+            else
+            {
+                // the halves are vertical strips with disjoint regions of the arena
+                allocator right_alloc = alloc.split(region(mid));
+                std::future<std::pair<index_t, index_t> > left_task = std::async(std::launch::async, [&]
+                {
+                    return build(lo, mid, alloc, threads - threads / 2);
+                });
+                right = build(mid, hi, right_alloc, threads / 2);
+                left = left_task.get();
+                alloc.join(right_alloc);
+            }
+            return merge(left, right, alloc);
+        }
+
+        // joins two adjacent triangulations by zipping the seam from the lower common tangent upwards
+        std::pair<index_t, index_t> merge(std::pair<index_t, index_t> left, std::pair<index_t, index_t> right, allocator &alloc)
+        {
+            index_t ldo = left.first, ldi = left.second;
+            index_t rdi = right.first, rdo = right.second;
+
+            // lower common tangent
+            for (;;)
+            {
+                if (left_of(org(rdi), ldi))
+                    ldi = lnext(ldi);
+                else if (right_of(org(ldi), rdi))
+                    rdi = rprev(rdi);
+                else
+                    break;
+            }
+
+            index_t basel = connect(sym(rdi), ldi, alloc);
+            if (org(ldi) == org(ldo))
+                ldo = sym(basel);
+            if (org(rdi) == org(rdo))
+                rdo = basel;
+
+            for (;;)
+            {
+                // candidates above the base edge, edges whose circle contains the next candidate are not Delaunay
+                index_t lcand = onext(sym(basel));
+                bool lvalid = right_of(dest(lcand), basel);
+                if (lvalid)
+                {
+                    while (in_circle(dest(basel), org(basel), dest(lcand), dest(onext(lcand))))
+                    {
+                        index_t t = onext(lcand);
+                        remove_edge(lcand, alloc);
+                        lcand = t;
+                    }
+                }
+                index_t rcand = oprev(basel);
+                bool rvalid = right_of(dest(rcand), basel);
+                if (rvalid)
+                {
+                    while (in_circle(dest(basel), org(basel), dest(rcand), dest(oprev(rcand))))
+                    {
+                        index_t t = oprev(rcand);
+                        remove_edge(rcand, alloc);
+                        rcand = t;
+                    }
+                }
+                if (!lvalid && !rvalid)
+                    break;
+                if (!lvalid || (rvalid && in_circle(dest(lcand), org(lcand), org(rcand), dest(rcand))))
+                    basel = connect(rcand, sym(basel), alloc);
+                else
+                    basel = connect(sym(basel), sym(lcand), alloc);
+            }
+            return std::make_pair(ldo, rdo);
+        }
+
+    public:
+        // the triangulation does not depend on the number of threads
+        template <class Iter>
+        static_triangulation(Iter begin, Iter end, size_t threads = 1)
+            : points(begin, end)
+            , orient(points.begin(), points.end())
+        {
+            parallel_sort(points.begin(), points.end(), threads);
+            points.erase(std::unique(points.begin(), points.end()), points.end());
+            if (points.size() < 2)
+                return;
+            next.resize(region(points.size()));
+            origin.resize(region(points.size()), npos);
+            allocator alloc;
+            alloc.fresh.push_back(std::make_pair(region(0), region(points.size())));
+            build(0, points.size(), alloc, threads);
+        }
+
+        std::vector<triangle_2t<Scalar> > get_triangles() const
+        {
+            std::vector<triangle_2t<Scalar> > res;
+            std::vector<bool> visited(next.size());
+            // every face is the lnext cycle of its edges, the outer face is the only one traversed clockwise
+            for (index_t e = 0; e < next.size(); e += 2)
+            {
+                if (origin[e] == npos || visited[e])
+                    continue;
+                size_t length = 0;
+                index_t ep = e;
+                do
+                {
+                    visited[ep] = true;
+                    ep = lnext(ep);
+                    ++length;
+                } while (ep != e);
+                if (length == 3 && ccw(org(e), dest(e), dest(lnext(e))))
+                    res.push_back(triangle_2t<Scalar>(points[org(e)], points[dest(e)], points[dest(lnext(e))]));
+            }
+            return res;
+        }
+    };
+
+    template <typename Scalar>
+    const typename static_triangulation<Scalar>::index_t static_triangulation<Scalar>::npos;
+}
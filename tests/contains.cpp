@@ -7,8 +7,11 @@
 #include <cg/operations/contains/segment_point.h>
 #include <cg/operations/contains/triangle_point.h>
 #include <cg/operations/contains/contour_point.h>
+#include <cg/operations/contains/prepared_contour_point.h>
 #include <cg/convex_hull/graham.h>
 
+#include <cmath>
+
 TEST(contains, triangle_point)
 {
    using cg::point_2;
@@ -392,3 +395,128 @@ TEST(contains, convex_ccw_point_uniform1)
       }
    }
 }
+
+TEST(contains, integer)
+{
+   using cg::point_2i;
+
+   const int m = std::numeric_limits<int>::max(), n = std::numeric_limits<int>::min();
+   std::vector<point_2i> pts = boost::assign::list_of(point_2i(n, n))
+                                                     (point_2i(m, n))
+                                                     (point_2i(m, m))
+                                                     (point_2i(n, m));
+   cg::contour_2i square(pts);
+
+   EXPECT_TRUE(cg::convex_contains(square, point_2i(0, 0)));
+   EXPECT_TRUE(cg::convex_contains(square, point_2i(m, 0)));
+   EXPECT_TRUE(cg::contains(square, point_2i(n + 1, m - 1)));
+   EXPECT_TRUE(cg::contains(cg::triangle_2i(pts[0], pts[1], pts[2]), point_2i(m - 1, n + 1)));
+   EXPECT_FALSE(cg::contains(cg::triangle_2i(pts[0], pts[1], pts[2]), point_2i(m - 1, m)));
+   EXPECT_TRUE(cg::contains(cg::segment_2i(pts[0], pts[2]), point_2i(0, 0)));
+   EXPECT_FALSE(cg::contains(cg::segment_2i(pts[0], pts[2]), point_2i(0, 1)));
+}
+
+TEST(contains, prepared_convex_contour)
+{
+   using cg::point_2;
+   using cg::contour_2;
+
+   // hulls of points on a small grid, so that many queries are on the edges and on the rays from c[0]
+   util::uniform_random_int<int> rand(-20, 20);
+   for (size_t count : {1, 2, 3, 10, 100, 1000})
+   {
+      std::vector<point_2> pts(count);
+      for (point_2 & p : pts)
+      {
+         int x, y;
+         rand >> x;
+         rand >> y;
+         p = point_2(x, y);
+      }
+      pts.erase(cg::graham_hull(pts.begin(), pts.end()), pts.end());
+      contour_2 cont(pts);
+      cg::prepared_convex_contour<double> prepared(cont);
+
+      std::vector<point_2> queries;
+      for (int x = -22; x <= 22; ++x)
+         for (int y = -22; y <= 22; ++y)
+            queries.push_back(point_2(x + .5 * (y % 2), y));
+      queries.insert(queries.end(), pts.begin(), pts.end());
+
+      std::vector<bool> res;
+      prepared.contains(queries.begin(), queries.end(), std::back_inserter(res));
+      ASSERT_EQ(queries.size(), res.size());
+      for (size_t l = 0; l != queries.size(); ++l)
+      {
+         EXPECT_EQ(cg::convex_contains(cont, queries[l]), res[l]);
+         EXPECT_EQ(cg::convex_contains(cont, queries[l]), prepared.contains(queries[l]));
+      }
+   }
+}
+
+TEST(contains, prepared_contour)
+{
+   using cg::point_2;
+   using cg::contour_2;
+
+   std::vector<contour_2> contours;
+
+   // a comb with horizontal and vertical edges and a repeated vertex
+   contours.push_back(contour_2(boost::assign::list_of(point_2(0, 0))(point_2(1, 0))(point_2(1, 3))(point_2(2, 3))
+                                                      (point_2(2, 0))(point_2(4, 0))(point_2(4, 4))(point_2(4, 4))
+                                                      (point_2(0, 4))));
+
+   // star-shaped polygons with vertices on a small grid, sorted by the angle around the origin
+   util::uniform_random_int<int> rand(-20, 20);
+   for (size_t count : {3, 10, 100, 1000})
+   {
+      std::vector<point_2> pts(count);
+      for (point_2 & p : pts)
+      {
+         int x, y;
+         rand >> x;
+         rand >> y;
+         p = point_2(x, y);
+      }
+      std::sort(pts.begin(), pts.end(), [](point_2 const & a, point_2 const & b)
+                                        { return std::atan2(a.y, a.x) < std::atan2(b.y, b.x); });
+      contours.push_back(contour_2(pts));
+   }
+
+   for (contour_2 const & cont : contours)
+   {
+      cg::prepared_contour<double> prepared(cont);
+
+      std::vector<point_2> queries;
+      for (int x = -22; x <= 22; ++x)
+         for (int y = -22; y <= 22; ++y)
+            for (double dx : {0., .5})
+               for (double dy : {0., .5})
+                  queries.push_back(point_2(x + dx, y + dy));
+      queries.insert(queries.end(), cont.begin(), cont.end());
+
+      std::vector<bool> res;
+      prepared.contains(queries.begin(), queries.end(), std::back_inserter(res));
+      ASSERT_EQ(queries.size(), res.size());
+      for (size_t l = 0; l != queries.size(); ++l)
+         EXPECT_EQ(cg::contains(cont, queries[l]), res[l]) << queries[l].x << " " << queries[l].y;
+   }
+
+   EXPECT_FALSE(cg::prepared_contour<double>(contour_2(std::vector<point_2>())).contains(point_2(0, 0)));
+}
+
+TEST(contains, prepared_contour_uniform)
+{
+   using cg::point_2;
+
+   std::vector<point_2> pts = uniform_points(10000);
+   std::sort(pts.begin(), pts.end(), [](point_2 const & a, point_2 const & b)
+                                     { return std::atan2(a.y, a.x) < std::atan2(b.y, b.x); });
+   cg::contour_2 cont(pts);
+   cg::prepared_contour<double> prepared(cont);
+
+   std::vector<point_2> queries = uniform_points(10000);
+   queries.insert(queries.end(), pts.begin(), pts.end());
+   for (point_2 const & q : queries)
+      EXPECT_EQ(cg::contains(cont, q), prepared.contains(q));
+}
@@ -7,6 +7,17 @@
 #include <cg/convex_hull/jarvis.h>
 #include <cg/operations/contains/segment_point.h>
 #include <cg/convex_hull/quick_hull.h>
+#include <cg/convex_hull/akl_toussaint.h>
+#include <cg/convex_hull/chan.h>
+#include <cg/convex_hull/streaming.h>
+#include <cg/convex_hull/batch.h>
+#include <cg/convex_hull/melkman.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <sstream>
 
 #include "random_utils.h"
 
@@ -29,6 +40,16 @@ bool is_convex_hull(FwdIter p, FwdIter c, FwdIter q)
    return true;
 }
 
+// distinct vertices of a hull in the lexicographic order, andrew_hull returns a repeated point twice
+template <class FwdIter>
+std::vector<typename std::iterator_traits<FwdIter>::value_type> hull_vertices(FwdIter p, FwdIter q)
+{
+   std::vector<typename std::iterator_traits<FwdIter>::value_type> res(p, q);
+   std::sort(res.begin(), res.end());
+   res.erase(std::unique(res.begin(), res.end()), res.end());
+   return res;
+}
+
 TEST(graham_hull, simple)
 {
    using cg::point_2;
@@ -300,3 +321,343 @@ TEST(jarvis_hull, same_line)
       std::random_shuffle(pts.begin(), pts.end());
    }
 }
+
+TEST(convex_hull, integer)
+{
+   using cg::point_2i;
+
+   // coordinates at which the orientation determinant does not fit into a double
+   util::uniform_random_int<int, std::mt19937> distr(-(1 << 30), 1 << 30);
+   std::vector<point_2i> pts(10000);
+   for (point_2i & p : pts)
+      p = point_2i(distr(), distr());
+
+   std::vector<point_2i> res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::andrew_hull(res.begin(), res.end()), res.end()));
+   res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::graham_hull(res.begin(), res.end()), res.end()));
+   res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::quick_hull(res.begin(), res.end()), res.end()));
+   res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::jarvis_hull(res.begin(), res.end()), res.end()));
+}
+
+TEST(convex_hull, float)
+{
+   using cg::point_2f;
+
+   std::vector<cg::point_2> dpts = uniform_points(10000);
+   std::vector<point_2f> pts(dpts.begin(), dpts.end());
+
+   std::vector<point_2f> res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::andrew_hull(res.begin(), res.end()), res.end()));
+   res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::graham_hull(res.begin(), res.end()), res.end()));
+   res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::quick_hull(res.begin(), res.end()), res.end()));
+   res = pts;
+   EXPECT_TRUE(is_convex_hull(res.begin(), cg::jarvis_hull(res.begin(), res.end()), res.end()));
+}
+
+TEST(quick_hull, parallel)
+{
+   using cg::point_2;
+
+   // the small inputs are below the cutoff, everything runs on the calling thread
+   for (std::vector<point_2> const & pts : hull_stress_inputs(300000))
+   {
+      std::vector<point_2> expected = pts;
+      expected.erase(cg::quick_hull(expected.begin(), expected.end()), expected.end());
+
+      for (size_t threads : {2, 3, 8})
+      {
+         std::vector<point_2> res = pts;
+         res.erase(cg::quick_hull(res.begin(), res.end(), threads), res.end());
+         EXPECT_EQ(expected, res);
+      }
+   }
+}
+
+TEST(convex_hull, parallel)
+{
+   using cg::point_2;
+   typedef std::vector<point_2>::iterator iter;
+
+   std::vector<std::function<iter (iter, iter, size_t)> > hulls;
+   hulls.push_back([](iter b, iter e, size_t threads) { return cg::andrew_hull(b, e, threads); });
+   hulls.push_back([](iter b, iter e, size_t threads) { return cg::graham_hull(b, e, threads); });
+
+   for (std::vector<point_2> const & pts : hull_stress_inputs(300000))
+   {
+      std::vector<point_2> expected = pts;
+      expected = hull_vertices(expected.begin(), cg::graham_hull(expected.begin(), expected.end()));
+
+      std::vector<point_2> sorted_pts = pts;
+      std::sort(sorted_pts.begin(), sorted_pts.end());
+
+      for (auto const & hull : hulls)
+         for (size_t threads : {2, 3, 8})
+         {
+            std::vector<point_2> res = pts;
+            iter e = hull(res.begin(), res.end(), threads);
+            EXPECT_TRUE(is_convex_hull(res.begin(), e, res.end()));
+            EXPECT_TRUE(*std::min_element(res.begin(), e) == res.front());
+
+            EXPECT_EQ(expected, hull_vertices(res.begin(), e));
+
+            std::sort(res.begin(), res.end());
+            EXPECT_EQ(sorted_pts, res);
+         }
+   }
+}
+
+TEST(akl_toussaint, same_hull)
+{
+   using cg::point_2;
+   typedef std::vector<point_2>::iterator iter;
+
+   std::vector<std::vector<point_2> > inputs = hull_stress_inputs(20000);
+
+   for (std::vector<point_2> const & pts : inputs)
+   {
+      std::vector<point_2> expected = pts;
+      expected = hull_vertices(expected.begin(), cg::andrew_hull(expected.begin(), expected.end()));
+
+      for (iter (*hull)(iter, iter) : {&cg::andrew_hull<iter>, &cg::graham_hull<iter>, &cg::jarvis_hull<iter>})
+      {
+         std::vector<point_2> res = pts;
+         EXPECT_EQ(expected, hull_vertices(res.begin(), cg::akl_toussaint_hull(res.begin(), res.end(), hull)));
+      }
+      std::vector<point_2> res = pts;
+      iter e = cg::akl_toussaint_hull(res.begin(), res.end(), [](iter b, iter e) { return cg::quick_hull(b, e); });
+      EXPECT_EQ(expected, hull_vertices(res.begin(), e));
+   }
+
+   // most of the uniform points are dropped
+   std::vector<point_2> pts = inputs[0];
+   EXPECT_LT(cg::akl_toussaint_filter(pts.begin(), pts.end()) - pts.begin(), 10000);
+}
+
+TEST(chan_hull, simple)
+{
+   using cg::point_2;
+
+   std::vector<point_2> pts = boost::assign::list_of(point_2(0, 0))
+                                                    (point_2(1, 0))
+                                                    (point_2(0, 1))
+                                                    (point_2(2, 0))
+                                                    (point_2(0, 2))
+                                                    (point_2(3, 0));
+
+   EXPECT_TRUE(is_convex_hull(pts.begin(), cg::chan_hull(pts.begin(), pts.end()), pts.end()));
+}
+
+TEST(chan_hull, same_hull)
+{
+   using cg::point_2;
+
+   for (std::vector<point_2> const & pts : hull_stress_inputs(1000000))
+   {
+      std::vector<point_2> expected = pts;
+      expected = hull_vertices(expected.begin(), cg::andrew_hull(expected.begin(), expected.end()));
+
+      std::vector<point_2> res = pts;
+      std::vector<point_2>::iterator end = cg::chan_hull(res.begin(), res.end());
+      EXPECT_TRUE(is_convex_hull(res.begin(), end, res.end()));
+      std::sort(res.begin(), end);
+      EXPECT_EQ(expected, std::vector<point_2>(res.begin(), end));
+
+      // the range keeps all the points
+      std::sort(res.begin(), res.end());
+      std::vector<point_2> sorted = pts;
+      std::sort(sorted.begin(), sorted.end());
+      EXPECT_EQ(sorted, res);
+   }
+}
+
+TEST(chan_hull, many_vertices)
+{
+   using cg::point_2;
+
+   // points of a circle around smaller random points, the first round fails
+   std::vector<point_2> pts = uniform_points(20000);
+   for (point_2 & p : pts)
+      p = point_2(p.x / 1000, p.y / 1000);
+   for (int i = 0; i != 2000; ++i)
+   {
+      double phi = 6.283185307179586 * i / 2000;
+      pts.push_back(point_2(std::cos(phi), std::sin(phi)));
+   }
+   std::random_shuffle(pts.begin(), pts.end());
+   std::vector<point_2> expected = pts;
+   size_t count = cg::andrew_hull(expected.begin(), expected.end()) - expected.begin();
+
+   std::vector<point_2>::iterator end = cg::chan_hull(pts.begin(), pts.end());
+   EXPECT_TRUE(is_convex_hull(pts.begin(), end, pts.end()));
+   EXPECT_EQ(count, size_t(end - pts.begin()));
+}
+
+TEST(streaming_hull, same_hull)
+{
+   using cg::point_2;
+
+   for (std::vector<point_2> const & pts : hull_stress_inputs(100000))
+   {
+      std::vector<point_2> expected = pts;
+      expected = hull_vertices(expected.begin(), cg::andrew_hull(expected.begin(), expected.end()));
+
+      for (size_t chunk : {1, 7, 1000, 1000000})
+      {
+         cg::streaming_hull<point_2> h(chunk);
+         h.add_points(pts.begin(), pts.end());
+         std::vector<point_2> res = h.hull();
+         EXPECT_TRUE(is_convex_hull(res.begin(), res.end(), res.end()));
+         EXPECT_EQ(expected, hull_vertices(res.begin(), res.end()));
+      }
+   }
+}
+
+TEST(streaming_hull, stream)
+{
+   using cg::point_2;
+
+   std::vector<point_2> pts = boost::assign::list_of(point_2(0, 0))
+                                                    (point_2(1, 0))
+                                                    (point_2(0, 1))
+                                                    (point_2(2, 0))
+                                                    (point_2(0, 2))
+                                                    (point_2(3, 0))
+                                                    (point_2(1, 1));
+   std::stringstream in;
+   for (point_2 const & p : pts)
+      in << p << "\n";
+
+   std::vector<point_2> res = cg::streaming_hull_of<double>(in, 2);
+   EXPECT_TRUE(is_convex_hull(res.begin(), res.end(), res.end()));
+   EXPECT_EQ(3u, res.size());
+}
+
+TEST(batch_hull, same_hulls)
+{
+   using cg::point_2;
+
+   // sets of every size from 0 to 200, and one of equal points
+   std::vector<point_2> points;
+   std::vector<size_t> offsets(1, 0);
+   for (size_t size = 0; size <= 200; ++size)
+   {
+      std::vector<point_2> pts = uniform_points(size);
+      points.insert(points.end(), pts.begin(), pts.end());
+      offsets.push_back(points.size());
+   }
+   points.insert(points.end(), 10, point_2(3, 4));
+   offsets.push_back(points.size());
+
+   for (size_t threads : {1, 3, 8})
+   {
+      std::vector<point_2> hull_points;
+      std::vector<size_t> hull_offsets;
+      cg::batch_hull(points, offsets, hull_points, hull_offsets, threads);
+
+      ASSERT_EQ(offsets.size(), hull_offsets.size());
+      for (size_t i = 0; i + 1 != offsets.size(); ++i)
+      {
+         std::vector<point_2> expected(points.begin() + offsets[i], points.begin() + offsets[i + 1]);
+         expected.erase(cg::andrew_hull(expected.begin(), expected.end()), expected.end());
+         EXPECT_EQ(expected, std::vector<point_2>(hull_points.begin() + hull_offsets[i], hull_points.begin() + hull_offsets[i + 1]));
+      }
+      EXPECT_EQ(hull_offsets.back(), hull_points.size());
+   }
+
+   std::vector<point_2> hull_points(1);
+   std::vector<size_t> hull_offsets(1);
+   cg::batch_hull(std::vector<point_2>(), std::vector<size_t>(), hull_points, hull_offsets);
+   EXPECT_TRUE(hull_points.empty());
+   EXPECT_EQ(std::vector<size_t>(1, 0), hull_offsets);
+}
+
+TEST(melkman_hull, simple)
+{
+   using cg::point_2;
+
+   // a comb with collinear vertices on the hull edges
+   std::vector<point_2> pts = boost::assign::list_of(point_2(4, 4))
+                                                    (point_2(0, 4))
+                                                    (point_2(0, 2))
+                                                    (point_2(0, 0))
+                                                    (point_2(1, 0))
+                                                    (point_2(1, 3))
+                                                    (point_2(2, 3))
+                                                    (point_2(2, 0))
+                                                    (point_2(3, 0))
+                                                    (point_2(3, 3))
+                                                    (point_2(4, 3))
+                                                    (point_2(4, 4));
+
+   std::vector<point_2> expected = boost::assign::list_of(point_2(0, 0))
+                                                         (point_2(3, 0))
+                                                         (point_2(4, 3))
+                                                         (point_2(4, 4))
+                                                         (point_2(0, 4));
+
+   cg::contour_2 hull = cg::melkman_hull(cg::contour_2(pts));
+   EXPECT_EQ(expected, std::vector<point_2>(hull.begin(), hull.end()));
+
+   std::vector<point_2> res;
+   cg::melkman_hull(pts.begin(), pts.end(), std::back_inserter(res));
+   EXPECT_EQ(expected, res);
+}
+
+TEST(melkman_hull, degenerate)
+{
+   using cg::point_2;
+
+   std::vector<point_2> res;
+   std::vector<point_2> pts;
+   cg::melkman_hull(pts.begin(), pts.end(), std::back_inserter(res));
+   EXPECT_TRUE(res.empty());
+
+   pts.assign(5, point_2(1, 1));
+   cg::melkman_hull(pts.begin(), pts.end(), std::back_inserter(res));
+   EXPECT_EQ(std::vector<point_2>(1, point_2(1, 1)), res);
+
+   pts = boost::assign::list_of(point_2(0, 0))(point_2(1, 1))(point_2(1, 1))(point_2(3, 3));
+   res.clear();
+   cg::melkman_hull(pts.begin(), pts.end(), std::back_inserter(res));
+   EXPECT_EQ(std::vector<point_2>(boost::assign::list_of(point_2(0, 0))(point_2(3, 3))), res);
+
+   // descending along the line, the output still starts from the smallest point
+   pts = boost::assign::list_of(point_2(2, 0))(point_2(1, 0))(point_2(0, 0));
+   res.clear();
+   cg::melkman_hull(pts.begin(), pts.end(), std::back_inserter(res));
+   EXPECT_EQ(std::vector<point_2>(boost::assign::list_of(point_2(0, 0))(point_2(2, 0))), res);
+
+   cg::contour_2 hull = cg::melkman_hull(cg::contour_2(pts));
+   EXPECT_EQ(std::vector<point_2>(boost::assign::list_of(point_2(0, 0))(point_2(2, 0))), std::vector<point_2>(hull.begin(), hull.end()));
+}
+
+TEST(melkman_hull, uniform)
+{
+   using cg::point_2;
+
+   for (size_t count : {3, 10, 1000, 100000})
+   {
+      // points sorted by the angle around the origin make a star-shaped polygon, and sorted by x a
+      // monotone polyline
+      std::vector<point_2> pts = uniform_points(count);
+      std::sort(pts.begin(), pts.end(), [](point_2 const & a, point_2 const & b)
+                                        { return std::atan2(a.y, a.x) < std::atan2(b.y, b.x); });
+      std::vector<point_2> polyline = pts;
+      std::sort(polyline.begin(), polyline.end());
+
+      std::vector<point_2> expected = pts;
+      expected.erase(cg::graham_hull(expected.begin(), expected.end()), expected.end());
+
+      cg::contour_2 hull = cg::melkman_hull(cg::contour_2(pts));
+      EXPECT_EQ(expected, std::vector<point_2>(hull.begin(), hull.end()));
+
+      std::vector<point_2> res;
+      cg::melkman_hull(polyline.begin(), polyline.end(), std::back_inserter(res));
+      EXPECT_EQ(expected, res);
+   }
+}
@@ -3,6 +3,12 @@
 #include "random_utils.h"
 
 #include <cg/triangulation/delaunay.h>
+#include <cg/triangulation/delaunay_dc.h>
+#include <cg/operations/distance.h>
+#include <cg/convex_hull/andrew.h>
+
+#include <cmath>
+#include <thread>
 
 using cg::point_2;
 using cg::triangulation;
@@ -19,6 +25,27 @@ bool check_triangulation(triangulation<double> const &tr)
     return true;
 }
 
+// a triangulation of n points with h of them on the hull consists of 2n - h - 2 triangles
+bool check_triangles_count(triangulation<double> const &tr, std::vector<point_2> pts)
+{
+    size_t h = std::distance(pts.begin(), cg::andrew_hull(pts.begin(), pts.end()));
+    return tr.get_triangles().size() == 2 * pts.size() - h - 2;
+}
+
+// triangles rotated to start at their least vertex, in sorted order
+std::vector<std::vector<point_2> > normalized(std::vector<triangle_2> const &triangles)
+{
+    std::vector<std::vector<point_2> > res;
+    for (triangle_2 const & t : triangles)
+    {
+        std::vector<point_2> v(&t[0], &t[0] + 3);
+        std::rotate(v.begin(), std::min_element(v.begin(), v.end()), v.end());
+        res.push_back(v);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
 TEST(delaunay_triangulation, uniform0)
 {
 
@@ -44,3 +71,358 @@ TEST(delaunay_triangulation, uniform1)
         EXPECT_TRUE(check_triangulation(tr));
     }
 }
+
+TEST(delaunay_triangulation, remove)
+{
+    const size_t cnt_points = 200;
+    for (size_t cnt_tests = 0; cnt_tests < 10; cnt_tests++)
+    {
+        std::vector<point_2> pts = uniform_points(cnt_points);
+        triangulation<double> tr;
+        for (size_t i = 0; i < cnt_points; ++i)
+            tr.add_point(pts[i]);
+        for (size_t i = 0; i < cnt_points - 3; ++i)
+        {
+            tr.remove_point(pts[i]);
+            if (i % 20 == 0)
+            {
+                EXPECT_TRUE(check_triangulation(tr));
+                EXPECT_TRUE(check_triangles_count(tr, std::vector<point_2>(pts.begin() + i + 1, pts.end())));
+            }
+        }
+        EXPECT_EQ(tr.get_triangles().size(), 1);
+        for (size_t i = cnt_points - 3; i < cnt_points; ++i)
+            tr.remove_point(pts[i]);
+        EXPECT_TRUE(tr.get_triangles().empty());
+        for (size_t i = 0; i < cnt_points; ++i)
+            tr.add_point(pts[i]);
+        EXPECT_TRUE(check_triangulation(tr));
+        EXPECT_TRUE(check_triangles_count(tr, pts));
+    }
+}
+
+TEST(delaunay_triangulation, remove_high_degree)
+{
+    // the center of a ring is connected to all of it, with points inside the ring the hole is not convex;
+    // a point just below the center of a half ring is on the hull and connected to all of the half ring
+    for (bool hull : {false, true})
+        for (double jitter : {1e-9, 1e-2})
+        {
+            double arc = hull ? 3.141592653589793 / 299 : 6.283185307179586 / 300;
+            point_2 center(0, hull ? -1e-3 : 0);
+            std::vector<point_2> pts;
+            for (size_t i = 0; i != 300; ++i)
+            {
+                double phi = arc * i, r = 1 + jitter * (i * 7919 % 101);
+                pts.push_back(point_2(r * std::cos(phi), r * std::sin(phi)));
+            }
+            for (point_2 const & p : uniform_points(20))
+                pts.push_back(point_2(p.x / 200, hull ? 0.05 + std::abs(p.y) / 200 : p.y / 200));
+
+            triangulation<double> tr(pts.begin(), pts.end());
+            for (size_t i = 0; i != 10; ++i)
+            {
+                tr.add_point(center);
+                tr.remove_point(center);
+                EXPECT_TRUE(check_triangulation(tr));
+                EXPECT_TRUE(check_triangles_count(tr, pts));
+                tr.remove_point(pts[pts.size() - 1 - i]);
+                tr.add_point(pts[pts.size() - 1 - i]);
+            }
+        }
+}
+
+TEST(delaunay_triangulation, remove_collinear)
+{
+    // the ends of a chain leave a hole of two edges, the middle points one between two infinite faces
+    std::vector<point_2> pts;
+    for (int i = 0; i != 5; ++i)
+        pts.push_back(point_2(i, 2 * i));
+
+    for (size_t removed = 0; removed != pts.size(); ++removed)
+    {
+        triangulation<double> tr;
+        for (point_2 const & p : pts)
+            tr.add_point(p);
+        tr.remove_point(pts[removed]);
+
+        EXPECT_TRUE(tr.get_triangles().empty());
+        EXPECT_FALSE(tr.contains_point(pts[removed]));
+        for (size_t i = 0; i != pts.size(); ++i)
+            if (i != removed)
+            {
+                EXPECT_TRUE(tr.contains_point(pts[i]));
+            }
+
+        // the rest is still a valid triangulation, the same as the one built without the point
+        tr.add_point(point_2(0, 1));
+        EXPECT_TRUE(check_triangulation(tr));
+        std::vector<point_2> rest(pts);
+        rest.erase(rest.begin() + removed);
+        rest.push_back(point_2(0, 1));
+        triangulation<double> expected;
+        for (point_2 const & p : rest)
+            expected.add_point(p);
+        EXPECT_EQ(normalized(expected.get_triangles()), normalized(tr.get_triangles()));
+    }
+}
+
+TEST(delaunay_triangulation, locate)
+{
+    const size_t cnt_points = 300;
+    for (size_t cnt_tests = 0; cnt_tests < 10; cnt_tests++)
+    {
+        std::vector<point_2> pts = uniform_points(cnt_points);
+        triangulation<double> tr;
+        for (size_t i = 0; i < cnt_points; ++i)
+            tr.add_point(pts[i]);
+        std::vector<triangle_2> triangles = tr.get_triangles();
+
+        std::vector<point_2> queries = uniform_points(cnt_points);
+        queries.insert(queries.end(), pts.begin(), pts.end());
+        for (point_2 const & q : queries)
+        {
+            boost::optional<triangle_2> t = tr.locate(q);
+            bool inside = std::any_of(triangles.begin(), triangles.end(),
+                                      [&q](triangle_2 const & t) { return cg::contains(t, q); });
+            EXPECT_EQ(inside, bool(t));
+            if (t)
+            {
+                EXPECT_TRUE(cg::contains(*t, q));
+            }
+        }
+    }
+}
+
+TEST(delaunay_triangulation, concurrent_locate)
+{
+    std::vector<point_2> pts = uniform_points(2000);
+    triangulation<double> tr(pts.begin(), pts.end());
+
+    std::vector<point_2> queries = uniform_points(2000);
+    std::vector<boost::optional<triangle_2> > expected;
+    for (point_2 const & q : queries)
+        expected.push_back(tr.locate(q));
+
+    // const queries write nothing shared, every thread walks with its own hint or none
+    std::vector<size_t> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k != mismatches.size(); ++k)
+        threads.push_back(std::thread([&, k]
+        {
+            triangulation<double>::locate_hint hint;
+            for (size_t i = 0; i != queries.size(); ++i)
+            {
+                boost::optional<triangle_2> t = k % 2 ? tr.locate(queries[i], hint) : tr.locate(queries[i]);
+                if (bool(t) != bool(expected[i]) || (t && !cg::contains(*t, queries[i])))
+                    ++mismatches[k];
+            }
+        }));
+    for (std::thread & t : threads)
+        t.join();
+    EXPECT_EQ(std::vector<size_t>(4, 0), mismatches);
+}
+
+TEST(delaunay_triangulation, grid)
+{
+    std::vector<point_2> pts;
+    for (int x = 0; x < 15; ++x)
+        for (int y = 0; y < 15; ++y)
+            pts.push_back(point_2((x * 7) % 15, (y * 11) % 15));
+    triangulation<double> tr;
+    for (point_2 const & p : pts)
+        tr.add_point(p);
+    EXPECT_TRUE(check_triangulation(tr));
+    EXPECT_EQ(tr.get_triangles().size(), 2 * 14 * 14);
+    for (point_2 const & p : pts)
+        EXPECT_TRUE(bool(tr.locate(p)));
+    EXPECT_FALSE(bool(tr.locate(point_2(-1, 7))));
+}
+
+TEST(delaunay_triangulation, bulk)
+{
+    const size_t cnt_points = 500;
+    for (size_t cnt_tests = 0; cnt_tests < 10; cnt_tests++)
+    {
+        std::vector<point_2> pts = uniform_points(cnt_points);
+        std::vector<point_2> input = pts;
+        input.insert(input.end(), pts.begin(), pts.begin() + cnt_points / 5);
+        triangulation<double> tr(input.begin(), input.end());
+        EXPECT_TRUE(check_triangulation(tr));
+        EXPECT_TRUE(check_triangles_count(tr, pts));
+        for (point_2 const & p : pts)
+            tr.remove_point(p);
+        EXPECT_TRUE(tr.get_triangles().empty());
+    }
+}
+
+TEST(delaunay_triangulation, bulk_outlier)
+{
+    // the grid of the bulk build covers the clustered points only
+    std::vector<point_2> pts = uniform_points(300);
+    triangulation<double> tr(pts.begin(), pts.end());
+
+    point_2 outlier(1e300, 1e300);
+    EXPECT_FALSE(bool(tr.locate(outlier)));
+    tr.add_point(outlier);
+    pts.push_back(outlier);
+    EXPECT_TRUE(check_triangles_count(tr, pts));
+    tr.remove_point(outlier);
+    pts.pop_back();
+    EXPECT_TRUE(check_triangulation(tr));
+    EXPECT_TRUE(check_triangles_count(tr, pts));
+}
+
+TEST(delaunay_triangulation, divide_and_conquer)
+{
+    for (size_t cnt_points = 0; cnt_points < 1000; cnt_points = cnt_points * 3 / 2 + 1)
+    {
+        std::vector<point_2> pts = uniform_points(cnt_points);
+        triangulation<double> tr(pts.begin(), pts.end());
+        cg::static_triangulation<double> dc(pts.begin(), pts.end());
+        EXPECT_EQ(normalized(tr.get_triangles()), normalized(dc.get_triangles()));
+    }
+
+    std::vector<point_2> line;
+    for (int i = 0; i < 10; ++i)
+        line.push_back(point_2(i, 2 * i));
+    EXPECT_TRUE(cg::static_triangulation<double>(line.begin(), line.end()).get_triangles().empty());
+
+    // cocircular points make the triangulation ambiguous, only its size is fixed
+    std::vector<point_2> grid;
+    for (int x = 0; x < 10; ++x)
+        for (int y = 0; y < 10; ++y)
+            grid.push_back(point_2(x, y));
+    cg::static_triangulation<double> dc(grid.begin(), grid.end());
+    std::vector<triangle_2> triangles = dc.get_triangles();
+    EXPECT_EQ(triangles.size(), 2 * 9 * 9);
+    for (triangle_2 const & t : triangles)
+    {
+        EXPECT_EQ(cg::orientation(t[0], t[1], t[2]), cg::CG_LEFT);
+        for (point_2 const & p : grid)
+            EXPECT_TRUE(delaunay_criterion(t[0], t[1], t[2], p));
+    }
+}
+
+TEST(delaunay_triangulation, parallel)
+{
+    std::vector<point_2> grid;
+    for (int x = 0; x < 150; ++x)
+        for (int y = 0; y < 150; ++y)
+            grid.push_back(point_2(x, y));
+    std::vector<point_2> random = uniform_points(20000);
+
+    for (std::vector<point_2> const * pts : {&grid, &random})
+    {
+        std::vector<std::vector<point_2> > expected =
+            normalized(cg::static_triangulation<double>(pts->begin(), pts->end()).get_triangles());
+        for (size_t threads : {2, 3, 8})
+        {
+            cg::static_triangulation<double> tr(pts->begin(), pts->end(), threads);
+            EXPECT_EQ(expected, normalized(tr.get_triangles()));
+        }
+    }
+}
+
+TEST(delaunay_triangulation, sliding_window)
+{
+    const size_t window = 100;
+    std::vector<point_2> pts = uniform_points(2000);
+    triangulation<double> tr;
+    for (size_t i = 0; i < pts.size(); ++i)
+    {
+        tr.add_point(pts[i]);
+        if (i >= window)
+            tr.remove_point(pts[i - window]);
+        if (i % 100 == 99)
+        {
+            std::vector<point_2> current(pts.begin() + (i + 1 - window), pts.begin() + i + 1);
+            EXPECT_TRUE(check_triangulation(tr));
+            EXPECT_TRUE(check_triangles_count(tr, current));
+            for (point_2 const & p : current)
+                EXPECT_TRUE(bool(tr.locate(p)));
+        }
+    }
+}
+
+TEST(delaunay_triangulation, find)
+{
+    std::vector<point_2> pts = uniform_points(300);
+    triangulation<double> tr;
+    EXPECT_FALSE(tr.contains_point(pts[0]));
+    for (point_2 const & p : pts)
+        tr.add_point(p);
+    for (point_2 const & p : pts)
+    {
+        EXPECT_TRUE(tr.contains_point(p));
+        boost::optional<triangulation<double>::vertex_handle> v = tr.find(p);
+        ASSERT_TRUE(bool(v));
+        EXPECT_EQ(p, tr.vertex(*v));
+    }
+    tr.add_point(point_2(-0., 0.));
+    EXPECT_TRUE(tr.contains_point(point_2(0., -0.)));
+    for (size_t i = 0; i < pts.size(); i += 2)
+        tr.remove_point(pts[i]);
+    for (size_t i = 0; i < pts.size(); ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, tr.contains_point(pts[i]));
+        if (i % 2 == 1)
+        {
+            EXPECT_EQ(pts[i], tr.vertex(*tr.find(pts[i])));
+        }
+    }
+}
+
+TEST(delaunay_triangulation, ranges)
+{
+    std::vector<point_2> pts = uniform_points(300);
+    triangulation<double> tr(pts.begin(), pts.end());
+    for (size_t i = 0; i < pts.size(); i += 3)
+        tr.remove_point(pts[i]);
+    std::vector<point_2> rest;
+    for (size_t i = 0; i < pts.size(); ++i)
+        if (i % 3 != 0)
+            rest.push_back(pts[i]);
+
+    std::vector<triangle_2> faces(tr.finite_faces().begin(), tr.finite_faces().end());
+    EXPECT_EQ(normalized(tr.get_triangles()), normalized(faces));
+
+    std::vector<point_2> vertices(tr.vertices().begin(), tr.vertices().end());
+    std::sort(vertices.begin(), vertices.end());
+    std::sort(rest.begin(), rest.end());
+    EXPECT_EQ(rest, vertices);
+
+    // every finite edge once: 3n - h - 3 of them
+    size_t h = std::distance(rest.begin(), cg::andrew_hull(rest.begin(), rest.end()));
+    EXPECT_EQ(3 * vertices.size() - h - 3, boost::size(tr.finite_edges()));
+
+    std::vector<point_2> vertex_buffer;
+    std::vector<std::array<std::uint32_t, 3> > triangle_buffer;
+    tr.export_indexed(vertex_buffer, triangle_buffer);
+    EXPECT_EQ(boost::size(tr.vertices()), vertex_buffer.size());
+    std::vector<triangle_2> exported;
+    for (std::array<std::uint32_t, 3> const & t : triangle_buffer)
+        exported.push_back(triangle_2(vertex_buffer[t[0]], vertex_buffer[t[1]], vertex_buffer[t[2]]));
+    EXPECT_EQ(normalized(faces), normalized(exported));
+}
+
+TEST(delaunay_triangulation, criterion_expansion)
+{
+    // points of a circle up to rounding and exactly cocircular integer points
+    std::vector<point_2> pts = uniform_points(4000);
+    for (size_t i = 0; i + 4 <= pts.size(); i += 4)
+    {
+        point_2 o = pts[i];
+        double r = 1 + fabs(pts[i + 1].x);
+        point_2 q[4];
+        for (size_t k = 0; k != 4; ++k)
+            q[k] = point_2(o.x + r * std::cos(pts[i + k].y), o.y + r * std::sin(pts[i + k].y));
+        EXPECT_EQ(*cg::delaunay_criterion_e()(q[0], q[1], q[2], q[3]), *cg::delaunay_criterion_r()(q[0], q[1], q[2], q[3]));
+        EXPECT_EQ(*cg::cmp_dist_e()(q[0], q[1], q[2], q[3]), *cg::cmp_dist_r()(q[0], q[1], q[2], q[3]));
+    }
+
+    point_2 a(1005, 17), b(997, 21), c(1000, 12), d(1003, 21);
+    EXPECT_TRUE(*cg::delaunay_criterion_e()(a, b, c, d));
+    EXPECT_FALSE(*cg::delaunay_criterion_e()(a, b, c, point_2(1003, 20.5)));
+    EXPECT_FALSE(*cg::cmp_dist_e()(a, c, d, b));
+}
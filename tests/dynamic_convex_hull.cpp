@@ -2,6 +2,10 @@
 #include <boost/assign/list_of.hpp>
 
 #include <cg/convex_hull/naive_dynamic.h>
+#include <cg/convex_hull/dynamic.h>
+#include <cg/convex_hull/andrew.h>
+#include <cg/convex_hull/incremental.h>
+#include <cg/operations/contains/contour_point.h>
 
 #include "random_utils.h"
 
@@ -145,3 +149,148 @@ TEST(dynamic_convex_hull, unifrom_with_deleting)
 
    EXPECT_TRUE(is_convex_hull(after_deleting.begin(), after_deleting.end(), dh.get_hull().first, dh.get_hull().second));
 }
+
+TEST(dynamic_convex_hull, balanced_with_deleting)
+{
+   using cg::point_2;
+
+   std::vector<point_2> pts = boost::assign::list_of(point_2(0, 0))
+                              (point_2(3, 0))
+                              (point_2(4, 2))
+                              (point_2(2, 2))
+                              (point_2(2, 4))
+                              (point_2(-1, 2))
+                              (point_2(1, 1))
+                              (point_2(0, 1));
+
+   std::vector<point_2> not_removed = boost::assign::list_of(point_2(0, 0))
+                                      (point_2(3, 0))
+                                      (point_2(2, 2))
+                                      (point_2(1, 1))
+                                      (point_2(0, 1));
+   cg::dynamic_hull dh;
+
+   for (point_2 p : pts)
+   {
+      dh.add_point(p);
+   }
+
+   dh.remove_point(point_2(4, 2));
+   dh.remove_point(point_2(-1, 2));
+   dh.remove_point(point_2(2, 4));
+   EXPECT_TRUE(is_convex_hull(not_removed.begin(), not_removed.end(), dh.get_hull().first, dh.get_hull().second));
+}
+
+TEST(dynamic_convex_hull, balanced_same_as_static)
+{
+   using cg::point_2;
+
+   for (std::vector<point_2> const & pts : hull_stress_inputs(3000))
+   {
+      cg::dynamic_hull dh;
+      std::vector<point_2> present;
+
+      for (size_t i = 0; i != 2 * pts.size(); ++i)
+      {
+         if (i < pts.size() && (rand() % 3 || present.empty()))
+         {
+            dh.add_point(pts[i]);
+            present.push_back(pts[i]);
+         }
+         else if (!present.empty())
+         {
+            size_t k = rand() % present.size();
+            dh.remove_point(present[k]);
+            present.erase(present.begin() + k);
+         }
+
+         std::vector<point_2> all(dh.get_all_points().first, dh.get_all_points().second);
+         std::vector<point_2> sorted = present;
+         std::sort(sorted.begin(), sorted.end());
+         ASSERT_EQ(sorted, all);
+
+         std::vector<point_2> res(dh.get_hull().first, dh.get_hull().second);
+         std::vector<point_2> expected = present;
+         expected.erase(cg::andrew_hull(expected.begin(), expected.end()), expected.end());
+         std::sort(expected.begin(), expected.end());
+         expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+         ASSERT_TRUE(is_convex_hull(present.begin(), present.end(), res.begin(), res.end()));
+         if (!res.empty())
+         {
+            ASSERT_EQ(*std::min_element(present.begin(), present.end()), res[0]);
+         }
+         std::sort(res.begin(), res.end());
+         ASSERT_EQ(expected, res);
+      }
+   }
+}
+
+TEST(dynamic_convex_hull, balanced_uniform)
+{
+   using cg::point_2;
+
+   std::vector<point_2> pts = uniform_points(100000);
+   cg::dynamic_hull dh;
+
+   for (point_2 p : pts)
+      dh.add_point(p);
+   EXPECT_TRUE(is_convex_hull(pts.begin(), pts.end(), dh.get_hull().first, dh.get_hull().second));
+
+   // the points in the order of their x are removed from one side of the tree
+   std::sort(pts.begin(), pts.end());
+   for (size_t i = 0; i != pts.size() / 2; ++i)
+      dh.remove_point(pts[i]);
+   EXPECT_TRUE(is_convex_hull(pts.begin() + pts.size() / 2, pts.end(), dh.get_hull().first, dh.get_hull().second));
+}
+
+TEST(incremental_convex_hull, same_as_static)
+{
+   using cg::point_2;
+
+   for (std::vector<point_2> const & pts : hull_stress_inputs(3000))
+   {
+      cg::incremental_hull ih;
+      for (size_t i = 0; i != pts.size(); ++i)
+      {
+         ih.add_point(pts[i]);
+
+         std::vector<point_2> res(ih.get_hull().first, ih.get_hull().second);
+         std::vector<point_2> expected(pts.begin(), pts.begin() + i + 1);
+         ASSERT_TRUE(is_convex_hull(expected.begin(), expected.end(), res.begin(), res.end()));
+         expected.erase(cg::andrew_hull(expected.begin(), expected.end()), expected.end());
+         std::sort(expected.begin(), expected.end());
+         expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+         std::sort(res.begin(), res.end());
+         ASSERT_EQ(expected, res);
+      }
+   }
+}
+
+TEST(incremental_convex_hull, contains)
+{
+   using cg::point_2;
+
+   cg::incremental_hull ih;
+   EXPECT_FALSE(ih.contains(point_2(0, 0)));
+   ih.add_point(point_2(0, 0));
+   EXPECT_TRUE(ih.contains(point_2(0, 0)));
+   EXPECT_FALSE(ih.contains(point_2(0, 1)));
+   ih.add_point(point_2(0, 2));
+   EXPECT_TRUE(ih.contains(point_2(0, 1)));
+   EXPECT_FALSE(ih.contains(point_2(0, 3)));
+   EXPECT_FALSE(ih.contains(point_2(1, 1)));
+
+   std::vector<point_2> pts = uniform_points(1000);
+   for (point_2 const & p : pts)
+      ih.add_point(p);
+
+   std::vector<point_2> hull(ih.get_hull().first, ih.get_hull().second);
+   cg::contour_2 contour(hull);
+   for (point_2 const & q : uniform_points(10000))
+      EXPECT_EQ(cg::convex_contains(contour, q), ih.contains(q));
+   for (point_2 const & p : pts)
+      EXPECT_TRUE(ih.contains(p));
+   for (point_2 const & p : hull)
+      EXPECT_TRUE(ih.contains(p));
+}
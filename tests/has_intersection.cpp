@@ -85,3 +85,18 @@ TEST(has_intersection, rectangle_segment)
    EXPECT_TRUE(cg::has_intersection(rectangle_2(a, b), segment_2(point_2(-1, -1), point_2(3, 3))));
    EXPECT_TRUE(cg::has_intersection(rectangle_2(a, b), segment_2(point_2(1, -1), point_2(1, 3))));
 }
+
+TEST(has_intersection, integer)
+{
+   using cg::point_2i;
+   using cg::segment_2i;
+
+   // nearly parallel long segments, 1 apart at one end
+   const int m = std::numeric_limits<int>::max(), n = std::numeric_limits<int>::min();
+   EXPECT_FALSE(cg::has_intersection(segment_2i(point_2i(n, n), point_2i(m, m - 1)),
+                                     segment_2i(point_2i(n, n + 1), point_2i(m, m))));
+   EXPECT_TRUE(cg::has_intersection(segment_2i(point_2i(n, n), point_2i(m, m)),
+                                    segment_2i(point_2i(n, n + 1), point_2i(m, m - 1))));
+   EXPECT_TRUE(cg::has_intersection(cg::triangle_2i(point_2i(n, n), point_2i(m, n), point_2i(m, m)),
+                                    segment_2i(point_2i(n, n + 1), point_2i(m, n + 2))));
+}
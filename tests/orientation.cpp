@@ -4,11 +4,18 @@
 
 #include <cg/primitives/contour.h>
 #include <cg/operations/orientation.h>
+#include <cg/operations/orientation_batch.h>
+#include <cg/common/predicate_stats.h>
 #include <cg/convex_hull/graham.h>
 #include <misc/random_utils.h>
 
 #include "random_utils.h"
 
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+
 using namespace util;
 
 TEST(orientation, uniform_line)
@@ -125,3 +132,186 @@ TEST(orientation, uniform1)
    }
 }
 
+
+TEST(orientation, semi_static)
+{
+   uniform_random_real<double, std::mt19937> distr(-2., 2.);
+
+   // c lies within 2 |ab| of a, so all the coordinates are at most 500
+   std::vector<cg::point_2> pts = uniform_points(1000);
+   cg::orientation_semi_static orient(500.);
+   for (size_t l = 0, ln = 1; ln < pts.size(); l = ln++)
+   {
+      cg::point_2 a = pts[l];
+      cg::point_2 b = pts[ln];
+
+      for (size_t k = 0; k != 300; ++k)
+      {
+         cg::point_2 c = a + distr() * (b - a);
+         EXPECT_EQ(orient(a, b, c), *cg::orientation_r()(a, b, c));
+      }
+   }
+}
+
+TEST(orientation, expansion)
+{
+   uniform_random_real<double, std::mt19937> distr(-2., 2.);
+
+   std::vector<cg::point_2> pts = uniform_points(1000);
+   for (size_t l = 0, ln = 1; ln < pts.size(); l = ln++)
+   {
+      cg::point_2 a = pts[l];
+      cg::point_2 b = pts[ln];
+
+      for (size_t k = 0; k != 300; ++k)
+      {
+         cg::point_2 c = a + distr() * (b - a);
+         cg::point_2 d = c + distr() * (b - a);
+         EXPECT_EQ(*cg::orientation_e()(a, b, c), *cg::orientation_r()(a, b, c));
+         EXPECT_EQ(*cg::orientation_e()(a, b, c, d), *cg::orientation_r()(a, b, c, d));
+      }
+   }
+}
+
+TEST(orientation, batch)
+{
+   uniform_random_real<double, std::mt19937> distr(-2., 2.);
+
+   // half of the points lie on the line ab up to rounding, the count is not a multiple of the vector width
+   std::vector<cg::point_2> pts = uniform_points(1001);
+   cg::point_2 a = pts[0], b = pts[1];
+   for (size_t i = 0; i < pts.size(); i += 2)
+      pts[i] = a + distr() * (b - a);
+
+   std::vector<cg::orientation_t> res(pts.size());
+   for (size_t n = 0; n <= pts.size(); n += 7)
+   {
+      cg::orientation_batch(a, b, pts.data() + pts.size() - n, n, res.data());
+      for (size_t i = 0; i != n; ++i)
+         EXPECT_EQ(res[i], *cg::orientation_r()(a, b, pts[pts.size() - n + i]));
+   }
+}
+
+TEST(orientation, predicate_stats)
+{
+   namespace stats = cg::predicate_stats;
+
+   stats::reset();
+   std::thread worker([] { stats::record(stats::cmp_dist, stats::filter, 3); });
+   stats::record(stats::cmp_dist, stats::filter, 1);
+   stats::record(stats::cmp_dist, stats::interval, 2);
+   worker.join();
+
+   // the counts of the exited thread are kept
+   stats::counts c = stats::collect();
+   EXPECT_EQ(c.calls[stats::cmp_dist][stats::filter], 4u);
+   EXPECT_EQ(c.calls[stats::cmp_dist][stats::interval], 2u);
+
+   std::ostringstream out;
+   stats::dump(out, c);
+   EXPECT_NE(out.str().find("50.0000% interval"), std::string::npos);
+
+   stats::reset();
+   EXPECT_EQ(stats::collect().calls[stats::cmp_dist][stats::filter], 0u);
+}
+
+#ifdef CG_PREDICATE_STATS
+TEST(orientation, float_stages)
+{
+   namespace stats = cg::predicate_stats;
+
+   // a collinear float query goes through the double filter once, then on to the interval stage
+   stats::reset();
+   EXPECT_EQ(cg::orientation(cg::point_2f(0, 0), cg::point_2f(1, 1), cg::point_2f(2, 2)), cg::CG_COLLINEAR);
+   stats::counts c = stats::collect();
+   EXPECT_EQ(c.calls[stats::orientation][stats::filter], 1u);
+   EXPECT_EQ(c.calls[stats::orientation][stats::interval], 1u);
+   stats::reset();
+}
+#endif
+
+TEST(orientation, integer)
+{
+   using cg::point_2i;
+
+   // the products of differences overflow 64 bits
+   const int m = std::numeric_limits<int>::max(), n = std::numeric_limits<int>::min();
+   EXPECT_EQ(cg::orientation(point_2i(n, n), point_2i(m, m), point_2i(n + 1, n)), cg::CG_RIGHT);
+   EXPECT_EQ(cg::orientation(point_2i(n, n), point_2i(m, m), point_2i(n, n + 1)), cg::CG_LEFT);
+   EXPECT_EQ(cg::orientation(point_2i(n, n), point_2i(m, m), point_2i(0, 0)), cg::CG_COLLINEAR);
+   EXPECT_EQ(cg::orientation(point_2i(n + 1, n), point_2i(m, m), point_2i(0, 0)), cg::CG_LEFT);
+
+   typedef cg::point_2t<std::int64_t> point_2l;
+   const std::int64_t big = (std::int64_t(1) << 62) - 1;
+   EXPECT_EQ(cg::orientation(point_2l(-big, -big), point_2l(big, big), point_2l(big - 1, big)), cg::CG_LEFT);
+   EXPECT_EQ(cg::orientation(point_2l(-big, -big), point_2l(big, big), point_2l(1, 1)), cg::CG_COLLINEAR);
+
+   util::uniform_random_int<int, std::mt19937> distr(-1000000, 1000000);
+   for (size_t k = 0; k != 10000; ++k)
+   {
+      point_2i a(distr(), distr()), b(distr(), distr()), c(distr(), distr());
+      EXPECT_EQ(cg::orientation(a, b, c), *cg::orientation_r()(a, b, c));
+   }
+}
+
+TEST(orientation, integer_expansion)
+{
+   typedef cg::orientation_kernel<std::int64_t> kernel;
+
+   // any 64-bit values, their products take up to 126 bits
+   const std::int64_t big = std::numeric_limits<std::int64_t>::max();
+   EXPECT_EQ(kernel::determinant_sign(big, big, big - 1, big), cg::CG_LEFT);
+   EXPECT_EQ(kernel::determinant_sign(big, -big, -big, big), cg::CG_COLLINEAR);
+   EXPECT_EQ(kernel::determinant_sign(-big, big, big, -big + 1), cg::CG_RIGHT);
+   EXPECT_EQ(kernel::determinant_sign(0, 5, 7, 1), cg::CG_RIGHT);
+
+   util::uniform_random_int<std::int64_t, std::mt19937> distr(-big, big);
+   for (size_t k = 0; k != 10000; ++k)
+   {
+      std::int64_t a = distr(), b = distr(), c = distr(), d = distr();
+      // the same product on both sides half of the time
+      if (k % 2)
+      {
+         b = a;
+         c = d;
+      }
+      mpz_class res = mpz_class(std::to_string(a)) * mpz_class(std::to_string(d)) - mpz_class(std::to_string(b)) * mpz_class(std::to_string(c));
+      EXPECT_EQ(kernel::determinant_sign(a, d, b, c), cg::orientation_t(sgn(res)));
+   }
+}
+
+TEST(orientation, integer_limits)
+{
+   typedef cg::point_2t<std::int64_t> point_2l;
+
+   auto exact = [](point_2l const & a, point_2l const & b, point_2l const & c)
+   {
+      auto z = [](std::int64_t v) { return mpz_class(std::to_string(v)); };
+      mpz_class res = (z(b.x) - z(a.x)) * (z(c.y) - z(a.y)) - (z(b.y) - z(a.y)) * (z(c.x) - z(a.x));
+      return cg::orientation_t(sgn(res));
+   };
+
+   // the differences of the coordinates take 64 bits and more
+   const std::int64_t lo = std::numeric_limits<std::int64_t>::min(), hi = std::numeric_limits<std::int64_t>::max();
+   EXPECT_EQ(cg::orientation(point_2l(lo, lo), point_2l(hi, hi), point_2l(0, 0)), cg::CG_COLLINEAR);
+   EXPECT_EQ(cg::orientation(point_2l(lo, lo), point_2l(hi, hi), point_2l(0, 1)), cg::CG_LEFT);
+   EXPECT_EQ(cg::orientation(point_2l(lo, lo), point_2l(hi, hi), point_2l(1, 0)), cg::CG_RIGHT);
+   EXPECT_EQ(cg::orientation(point_2l(lo, hi), point_2l(hi, lo), point_2l(0, -1)), cg::CG_COLLINEAR);
+   EXPECT_EQ(cg::orientation(point_2l(lo, hi), point_2l(hi, lo), point_2l(0, 0)), cg::CG_LEFT);
+   EXPECT_EQ(cg::orientation(point_2l(lo, lo), point_2l(hi, lo), point_2l(lo, hi), point_2l(hi, hi)), cg::CG_COLLINEAR);
+
+   // random points over the whole range and points close to a line through them
+   util::uniform_random_int<std::int64_t, std::mt19937> any(lo, hi), half(lo / 2, hi / 2), dir(-1000, 1000);
+   util::uniform_random_int<std::int64_t, std::mt19937> step(0, std::int64_t(1) << 52);
+   for (size_t k = 0; k != 10000; ++k)
+   {
+      point_2l a(any(), any()), b(any(), any()), c(any(), any());
+      EXPECT_EQ(exact(a, b, c), cg::orientation(a, b, c));
+
+      std::int64_t dx = dir(), dy = dir(), s = step(), t = step();
+      a = point_2l(half(), half());
+      b = point_2l(a.x + s * dx, a.y + s * dy);
+      c = point_2l(a.x - t * dx, a.y - t * dy + std::int64_t(k % 3) - 1);
+      EXPECT_EQ(exact(a, b, c), cg::orientation(a, b, c));
+   }
+}
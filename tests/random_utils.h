@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cmath>
+#include <vector>
+
 #include <boost/random.hpp>
 #include <cg/primitives/point.h>
 #include <misc/random_utils.h>
@@ -18,3 +21,39 @@ inline std::vector<cg::point_2> uniform_points(size_t count)
 
     return res;
 }
+
+// inputs on which the hull algorithms are checked against each other: random points, grids with many
+// collinear points on the hull and with ties between the extreme points, repeated points, points on a line,
+// equal points and small random sets of every size below 100. The large ones have about count points
+inline std::vector<std::vector<cg::point_2> > hull_stress_inputs(size_t count)
+{
+    using cg::point_2;
+
+    std::vector<std::vector<point_2> > res(1, uniform_points(count));
+
+    int side = int(std::sqrt(double(count)));
+    res.push_back(std::vector<point_2>());
+    for (int x = 0; x != side; ++x)
+        for (int y = 0; y != side; ++y)
+            res.back().push_back(point_2(x, y));
+
+    res.push_back(std::vector<point_2>());
+    for (int x = 0; x != side / 2; ++x)
+        for (int y = 0; y != side / 2; ++y)
+            res.back().push_back(point_2(x + y, x - y));
+
+    res.push_back(std::vector<point_2>());
+    for (size_t i = 0; i != count / 4; ++i)
+        res.back().push_back(point_2(i % 7, i % 11 + i % 3));
+
+    res.push_back(std::vector<point_2>());
+    for (size_t i = 0; i != count / 10; ++i)
+        res.back().push_back(point_2(i % 37, 2 * (i % 37)));
+
+    res.push_back(std::vector<point_2>(count / 10, point_2(1, 2)));
+
+    for (size_t cnt = 1; cnt != 100; ++cnt)
+        res.push_back(uniform_points(cnt));
+
+    return res;
+}